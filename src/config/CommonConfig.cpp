@@ -3,18 +3,28 @@
 const int         CommonConfig::DEFAULT_CLIENT_BODY_SIZE = 8192;
 const std::string CommonConfig::DEFAULT_ROOT = "/html";
 const std::string CommonConfig::DEFAULT_INDEX = "index.html";
+const int         CommonConfig::DEFAULT_GZIP_MIN_LENGTH = 20;
+const int         CommonConfig::DEFAULT_GZIP_COMP_LEVEL = 1;
 
 CommonConfig::CommonConfig():
   clientMaxBodySize(DEFAULT_CLIENT_BODY_SIZE),
   root(DEFAULT_ROOT),
   index(DEFAULT_INDEX),
-  errorPage() {}
+  errorPage(),
+  gzip(false),
+  gzipTypes(),
+  gzipMinLength(DEFAULT_GZIP_MIN_LENGTH),
+  gzipCompLevel(DEFAULT_GZIP_COMP_LEVEL) {}
 
 CommonConfig::CommonConfig(const CommonConfig& obj):
   clientMaxBodySize(obj.getClientMaxBodySize()),
   root(obj.getRoot()),
   index(obj.getIndex()),
-  errorPage(obj.getErrorPage()) {}
+  errorPage(obj.getErrorPage()),
+  gzip(obj.isGzip()),
+  gzipTypes(obj.getGzipTypes()),
+  gzipMinLength(obj.getGzipMinLength()),
+  gzipCompLevel(obj.getGzipCompLevel()) {}
 
 CommonConfig::~CommonConfig() {}
 
@@ -24,6 +34,10 @@ CommonConfig &CommonConfig::operator=(const CommonConfig& obj) {
     this->root = obj.getRoot();
     this->index = obj.getIndex();
     this->errorPage = obj.getErrorPage();
+    this->gzip = obj.isGzip();
+    this->gzipTypes = obj.getGzipTypes();
+    this->gzipMinLength = obj.getGzipMinLength();
+    this->gzipCompLevel = obj.getGzipCompLevel();
   }
   return *this;
 }
@@ -32,16 +46,38 @@ CommonConfig &CommonConfig::operator=(const CommonConfig& obj) {
 
 int CommonConfig::getClientMaxBodySize() const { return this->clientMaxBodySize; }
 
-std::string CommonConfig::getRoot() const { return this->root; }
+const std::string& CommonConfig::getRoot() const { return this->root; }
 
-std::map<int, std::string> CommonConfig::getErrorPage() const {
+const std::map<int, std::string>& CommonConfig::getErrorPage() const {
   return this->errorPage;
 }
 
-std::string CommonConfig::getIndex() const {
+const std::string& CommonConfig::getIndex() const {
   return this->index;
 }
 
+bool CommonConfig::isGzip() const { return this->gzip; }
+
+const std::vector<std::string>& CommonConfig::getGzipTypes() const { return this->gzipTypes; }
+
+bool CommonConfig::isGzipType(const std::string& contentType) const {
+  std::string type = contentType.substr(0, contentType.find(';'));
+
+  while (!type.empty() && type[type.length() - 1] == ' ')
+    type.erase(type.length() - 1);
+  if (type == "text/html")
+    return true;
+  for (size_t i = 0; i < this->gzipTypes.size(); ++i) {
+    if (this->gzipTypes[i] == "*" || this->gzipTypes[i] == type)
+      return true;
+  }
+  return false;
+}
+
+int CommonConfig::getGzipMinLength() const { return this->gzipMinLength; }
+
+int CommonConfig::getGzipCompLevel() const { return this->gzipCompLevel; }
+
 std::string CommonConfig::trimChar(std::string s, char c) const {
   size_t f, r;
 
@@ -74,13 +110,13 @@ std::string CommonConfig::combinePath(const std::string& s1, const std::string&
 }
 
 std::string CommonConfig::getErrorPageTargetPath(int status) const {
-  std::string errorPagePath = getErrorPage()[status];
+  std::map<int, std::string>::const_iterator it = this->errorPage.find(status);
   std::string ret;
 
-  if (errorPagePath == "")
+  if (it == this->errorPage.end() || it->second == "")
     return "";
 
-  ret = combinePath(this->root, errorPagePath);
+  ret = combinePath(this->root, it->second);
 
   return "." + ret;
 }
@@ -97,3 +133,11 @@ void CommonConfig::addErrorPage(int statusCode, std::string path) {
 }
 
 void CommonConfig::setIndex(std::string index) { this->index = index; }
+
+void CommonConfig::setGzip(bool gzip) { this->gzip = gzip; }
+
+void CommonConfig::setGzipTypes(const std::vector<std::string>& types) { this->gzipTypes = types; }
+
+void CommonConfig::setGzipMinLength(int length) { this->gzipMinLength = length; }
+
+void CommonConfig::setGzipCompLevel(int level) { this->gzipCompLevel = level; }
@@ -13,9 +13,15 @@ class CommonConfig {
     CommonConfig&               operator=(const CommonConfig& obj);
 
     int                         getClientMaxBodySize() const;
-    std::string                 getRoot() const;
-    std::map<int, std::string>  getErrorPage() const;
-    std::string                 getIndex() const;
+    const std::string&          getRoot() const;
+    const std::map<int, std::string>& getErrorPage() const;
+    const std::string&          getIndex() const;
+    bool                        isGzip() const;
+    const std::vector<std::string>& getGzipTypes() const;
+    // text/html always, then the gzip_types list, where "*" takes any
+    bool                        isGzipType(const std::string& contentType) const;
+    int                         getGzipMinLength() const;
+    int                         getGzipCompLevel() const;
 
     std::string                 getErrorPageTargetPath(int status) const;
 
@@ -23,15 +29,25 @@ class CommonConfig {
     void                        setRoot(std::string root);
     void                        addErrorPage(int statusCode, std::string path);
     void                        setIndex(std::string index);
+    void                        setGzip(bool gzip);
+    void                        setGzipTypes(const std::vector<std::string>& types);
+    void                        setGzipMinLength(int length);
+    void                        setGzipCompLevel(int level);
 
   protected:
     int                         clientMaxBodySize;
     std::string                 root;
     std::string                 index;
     std::map<int, std::string>  errorPage;
+    bool                        gzip;
+    std::vector<std::string>    gzipTypes;
+    int                         gzipMinLength;
+    int                         gzipCompLevel;
 
   private:
     static const int            DEFAULT_CLIENT_BODY_SIZE;
+    static const int            DEFAULT_GZIP_MIN_LENGTH;
+    static const int            DEFAULT_GZIP_COMP_LEVEL;
     static const std::string    DEFAULT_ROOT;
     static const std::string    DEFAULT_INDEX;
 
@@ -1,21 +1,43 @@
 #include "./Config.hpp"
 
-Config::Config(): is_already_set(false) {}
+const int Config::DEFAULT_WORKER_PROCESSES = 1;
+const int Config::DEFAULT_WORKER_THREADS = 0;
+
+Config::Config(): is_already_set(false), worker_processes(DEFAULT_WORKER_PROCESSES), worker_threads(DEFAULT_WORKER_THREADS) {}
 
 Config::~Config() {}
 
-Config::Config(const Config& obj) : http(obj.getHttpConfig()) {}
+Config::Config(const Config& obj) : http(obj.getHttpConfig()), worker_processes(obj.getWorkerProcesses()), worker_threads(obj.getWorkerThreads()) {}
 
 Config& Config::operator=(const Config& obj) {
-  if (this != &obj)
+  if (this != &obj) {
     this->http = obj.getHttpConfig();
+    this->worker_processes = obj.getWorkerProcesses();
+    this->worker_threads = obj.getWorkerThreads();
+  }
   return *this;
 }
 
-HttpConfig Config::getHttpConfig() const {
+const HttpConfig& Config::getHttpConfig() const {
   return this->http;
 }
 
+int Config::getWorkerProcesses() const {
+  return this->worker_processes;
+}
+
+int Config::getWorkerThreads() const {
+  return this->worker_threads;
+}
+
+void Config::setWorkerProcesses(int n) {
+  this->worker_processes = n;
+}
+
+void Config::setWorkerThreads(int n) {
+  this->worker_threads = n;
+}
+
 void Config::setHttpConfig(HttpConfig http) {
   if (this->is_already_set == false) {
     this->is_already_set = true;
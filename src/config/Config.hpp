@@ -10,14 +10,23 @@ class Config {
     Config();
     ~Config();
     Config(const Config& obj);
-    Config&     operator=(const Config& obj);
+    Config&            operator=(const Config& obj);
 
-    HttpConfig  getHttpConfig() const;
-    void        setHttpConfig(HttpConfig http);
+    const HttpConfig&  getHttpConfig() const;
+    int                getWorkerProcesses() const;
+    int                getWorkerThreads() const;
+    void               setHttpConfig(HttpConfig http);
+    void               setWorkerProcesses(int n);
+    void               setWorkerThreads(int n);
 
   private:
-    HttpConfig  http;
-    bool        is_already_set;
+    static const int   DEFAULT_WORKER_PROCESSES;
+    static const int   DEFAULT_WORKER_THREADS;
+
+    HttpConfig         http;
+    bool               is_already_set;
+    int                worker_processes;
+    int                worker_threads;
 };
 
 #endif
@@ -3,12 +3,32 @@
 const int HttpConfig::DEFAULT_CLIENT_HEADER_TIMEOUT = 60;
 const int HttpConfig::DEFAULT_CLIENT_BODY_TIMEOUT = 60;
 const int HttpConfig::DEFAULT_SEND_TIMEOUT = 60;
+// Empty means the platform default (epoll on Linux, select elsewhere)
+const std::string HttpConfig::DEFAULT_IO_ENGINE = "";
+// 0 entries, the cache is off until open_file_cache is set
+const int HttpConfig::DEFAULT_OPEN_FILE_CACHE_MAX = 0;
+const int HttpConfig::DEFAULT_OPEN_FILE_CACHE_INACTIVE = 60;
+const int HttpConfig::DEFAULT_OPEN_FILE_CACHE_VALID = 60;
+const int HttpConfig::DEFAULT_FILE_CACHE_BUDGET = 0;
+const int HttpConfig::DEFAULT_FILE_CACHE_MAX_FILE_SIZE = 1024 * 1024;
+// Off until negative_cache is set, misses kept a few seconds once on
+const int HttpConfig::DEFAULT_NEGATIVE_CACHE_MAX = 0;
+const int HttpConfig::DEFAULT_NEGATIVE_CACHE_VALID = 5;
 
 HttpConfig::HttpConfig():
   CommonConfig(),
   client_header_timeout(DEFAULT_CLIENT_HEADER_TIMEOUT),
   client_body_timeout(DEFAULT_CLIENT_BODY_TIMEOUT),
-  send_timeout(DEFAULT_SEND_TIMEOUT) {}
+  send_timeout(DEFAULT_SEND_TIMEOUT),
+  io_engine(DEFAULT_IO_ENGINE),
+  open_file_cache_max(DEFAULT_OPEN_FILE_CACHE_MAX),
+  open_file_cache_inactive(DEFAULT_OPEN_FILE_CACHE_INACTIVE),
+  open_file_cache_valid(DEFAULT_OPEN_FILE_CACHE_VALID),
+  file_cache_budget(DEFAULT_FILE_CACHE_BUDGET),
+  file_cache_max_file_size(DEFAULT_FILE_CACHE_MAX_FILE_SIZE),
+  negative_cache_max(DEFAULT_NEGATIVE_CACHE_MAX),
+  negative_cache_valid(DEFAULT_NEGATIVE_CACHE_VALID),
+  types_set(false) {}
 
 HttpConfig::~HttpConfig() {}
 
@@ -17,7 +37,18 @@ HttpConfig::HttpConfig(const HttpConfig& obj):
   client_header_timeout(obj.getClientHeaderTimeout()),
   client_body_timeout(obj.getClientBodyTimeout()),
   send_timeout(obj.getSendTimeout()),
-  servers(obj.getServerConfig()) {}
+  io_engine(obj.getIoEngine()),
+  open_file_cache_max(obj.getOpenFileCacheMax()),
+  open_file_cache_inactive(obj.getOpenFileCacheInactive()),
+  open_file_cache_valid(obj.getOpenFileCacheValid()),
+  file_cache_budget(obj.getFileCacheBudget()),
+  file_cache_max_file_size(obj.getFileCacheMaxFileSize()),
+  negative_cache_max(obj.getNegativeCacheMax()),
+  negative_cache_valid(obj.getNegativeCacheValid()),
+  types(obj.getTypes()),
+  types_set(obj.types_set),
+  servers(obj.getServerConfig()),
+  vhosts(obj.vhosts) {}
 
 HttpConfig& HttpConfig::operator=(const HttpConfig& obj) {
   if (this != &obj) {
@@ -25,11 +56,26 @@ HttpConfig& HttpConfig::operator=(const HttpConfig& obj) {
     this->root = obj.getRoot();
     this->errorPage = obj.getErrorPage();
     this->index = obj.getIndex();
+    this->gzip = obj.isGzip();
+    this->gzipTypes = obj.getGzipTypes();
+    this->gzipMinLength = obj.getGzipMinLength();
+    this->gzipCompLevel = obj.getGzipCompLevel();
 
     this->client_header_timeout = obj.getClientHeaderTimeout();
     this->client_body_timeout = obj.getClientBodyTimeout();
     this->send_timeout = obj.getSendTimeout();
+    this->io_engine = obj.getIoEngine();
+    this->open_file_cache_max = obj.getOpenFileCacheMax();
+    this->open_file_cache_inactive = obj.getOpenFileCacheInactive();
+    this->open_file_cache_valid = obj.getOpenFileCacheValid();
+    this->file_cache_budget = obj.getFileCacheBudget();
+    this->file_cache_max_file_size = obj.getFileCacheMaxFileSize();
+    this->negative_cache_max = obj.getNegativeCacheMax();
+    this->negative_cache_valid = obj.getNegativeCacheValid();
+    this->types = obj.getTypes();
+    this->types_set = obj.types_set;
     this->servers = obj.getServerConfig();
+    this->vhosts = obj.vhosts;
   }
   return *this;
 }
@@ -42,6 +88,24 @@ int HttpConfig::getClientBodyTimeout() const { return this->client_body_timeout;
 
 int HttpConfig::getSendTimeout() const { return this->send_timeout; }
 
+std::string HttpConfig::getIoEngine() const { return this->io_engine; }
+
+int HttpConfig::getOpenFileCacheMax() const { return this->open_file_cache_max; }
+
+int HttpConfig::getOpenFileCacheInactive() const { return this->open_file_cache_inactive; }
+
+int HttpConfig::getOpenFileCacheValid() const { return this->open_file_cache_valid; }
+
+int HttpConfig::getFileCacheBudget() const { return this->file_cache_budget; }
+
+int HttpConfig::getFileCacheMaxFileSize() const { return this->file_cache_max_file_size; }
+
+int HttpConfig::getNegativeCacheMax() const { return this->negative_cache_max; }
+
+int HttpConfig::getNegativeCacheValid() const { return this->negative_cache_valid; }
+
+const MimeType& HttpConfig::getTypes() const { return this->types; }
+
 const std::vector<ServerConfig>& HttpConfig::getServerConfig() const {
   return this->servers;
 }
@@ -54,29 +118,46 @@ void HttpConfig::setClientBodyTimeout(int n) { this->client_body_timeout = n; }
 
 void HttpConfig::setSendTimeout(int n) { this->send_timeout = n; }
 
-void HttpConfig::addServerConfig(ServerConfig server) {
-  for (size_t i = 0; i < this->servers.size(); ++i) {
-    if (this->servers[i].getPort() == server.getPort())
-      throw std::runtime_error("Server blocks on the same port are not allowed");
-    if (this->servers[i].getServerName() == server.getServerName())
-      throw std::runtime_error("Server blocks on the same server_name are not allowed");
-  }
-  this->servers.push_back(server);
+void HttpConfig::setIoEngine(std::string engine) { this->io_engine = engine; }
+
+void HttpConfig::setOpenFileCache(int max, int inactive) {
+  this->open_file_cache_max = max;
+  this->open_file_cache_inactive = inactive;
 }
 
-//
+void HttpConfig::setOpenFileCacheValid(int n) { this->open_file_cache_valid = n; }
 
-const ServerConfig& HttpConfig::findServerConfig(std::string reqHost) const {
-  size_t pos;
+void HttpConfig::setFileCache(int budget, int max_file_size) {
+  this->file_cache_budget = budget;
+  this->file_cache_max_file_size = max_file_size;
+}
 
-  if ((pos = reqHost.find(":")) != std::string::npos)
-    reqHost = reqHost.substr(0, pos);
+void HttpConfig::setNegativeCache(int max, int valid) {
+  this->negative_cache_max = max;
+  this->negative_cache_valid = valid;
+}
 
-  const std::vector<ServerConfig>& servers = getServerConfig();
-  for (std::vector<ServerConfig>::const_iterator sit = servers.begin(); sit != servers.end(); ++sit) {
-    if (sit->getServerName() == reqHost) {
-      return *sit;
-    }
-  }
-  return this->servers[0];
+void HttpConfig::addTypes(const std::vector<std::pair<std::string, std::string> >& types) {
+  if (!this->types_set)
+    this->types.clear();
+  this->types_set = true;
+  for (size_t i = 0; i < types.size(); ++i)
+    this->types.add(types[i].first, types[i].second);
+}
+
+void HttpConfig::addServerConfig(ServerConfig server) { this->servers.push_back(server); }
+
+void HttpConfig::compileServers() {
+  this->vhosts.compile(this->servers);
+  this->types.compile();
 }
+
+//
+
+const ServerConfig& HttpConfig::findServerConfig(int listen, const std::string& reqHost) const {
+  return this->servers[this->vhosts.find(listen, reqHost.c_str(), reqHost.length())];
+}
+
+int HttpConfig::findListen(in_addr_t addr, short port) const { return this->vhosts.findListen(addr, port); }
+
+const std::vector<std::pair<std::string, short> >& HttpConfig::getListens() const { return this->vhosts.getListens(); }
@@ -3,6 +3,8 @@
 
 # include "./CommonConfig.hpp"
 # include "./ServerConfig.hpp"
+# include "./VirtualHosts.hpp"
+# include "../http/MimeType.hpp"
 
 # include <stdexcept>
 # include <vector>
@@ -14,27 +16,67 @@ class HttpConfig: public CommonConfig {
     HttpConfig(const HttpConfig& obj);
     HttpConfig& operator=(const HttpConfig& obj);
 
-    const ServerConfig&               findServerConfig(std::string reqHost) const;
+    // The server for a Host header on the listen address group listen, see VirtualHosts
+    const ServerConfig&               findServerConfig(int listen, const std::string& reqHost) const;
+    int                               findListen(in_addr_t addr, short port) const;
+    const std::vector<std::pair<std::string, short> >& getListens() const;
 
     int                               getClientHeaderTimeout() const;
     int                               getClientBodyTimeout() const;
     int                               getSendTimeout() const;
+    std::string                       getIoEngine() const;
+    int                               getOpenFileCacheMax() const;
+    int                               getOpenFileCacheInactive() const;
+    int                               getOpenFileCacheValid() const;
+    int                               getFileCacheBudget() const;
+    int                               getFileCacheMaxFileSize() const;
+    int                               getNegativeCacheMax() const;
+    int                               getNegativeCacheValid() const;
+    const MimeType&                   getTypes() const;
     const std::vector<ServerConfig>&  getServerConfig() const;
 
     void                              setClientHeaderTimeout(int n);
     void                              setClientBodyTimeout(int n);
     void                              setSendTimeout(int n);
+    void                              setIoEngine(std::string engine);
+    void                              setOpenFileCache(int max, int inactive);
+    void                              setOpenFileCacheValid(int n);
+    void                              setFileCache(int budget, int max_file_size);
+    void                              setNegativeCache(int max, int valid);
+    // (extension, type) pairs of a types block, the first replaces the built-in table
+    void                              addTypes(const std::vector<std::pair<std::string, std::string> >& types);
     void                              addServerConfig(ServerConfig server);
+    // Builds the host routing and the types table, once the http block is fully parsed
+    void                              compileServers();
 
   private:
     static const int                  DEFAULT_CLIENT_HEADER_TIMEOUT;
     static const int                  DEFAULT_CLIENT_BODY_TIMEOUT;
     static const int                  DEFAULT_SEND_TIMEOUT;
+    static const std::string          DEFAULT_IO_ENGINE;
+    static const int                  DEFAULT_OPEN_FILE_CACHE_MAX;
+    static const int                  DEFAULT_OPEN_FILE_CACHE_INACTIVE;
+    static const int                  DEFAULT_OPEN_FILE_CACHE_VALID;
+    static const int                  DEFAULT_FILE_CACHE_BUDGET;
+    static const int                  DEFAULT_FILE_CACHE_MAX_FILE_SIZE;
+    static const int                  DEFAULT_NEGATIVE_CACHE_MAX;
+    static const int                  DEFAULT_NEGATIVE_CACHE_VALID;
 
     int                               client_header_timeout;
     int                               client_body_timeout;
     int                               send_timeout;
+    std::string                       io_engine;
+    int                               open_file_cache_max;
+    int                               open_file_cache_inactive;
+    int                               open_file_cache_valid;
+    int                               file_cache_budget;
+    int                               file_cache_max_file_size;
+    int                               negative_cache_max;
+    int                               negative_cache_valid;
+    MimeType                          types;
+    bool                              types_set;
     std::vector<ServerConfig>         servers;
+    VirtualHosts                      vhosts;
 };
 
 #endif
@@ -9,8 +9,11 @@ LocationConfig::LocationConfig():
   CommonConfig(),
   alias(DEFAULT_ALIAS),
   path(DEFAULT_PATH),
+  matchType(PREFIX),
   _return(std::make_pair(-1, "")),
-  autoindex(DEFAULT_AUTOINDEX) {
+  autoindex(DEFAULT_AUTOINDEX),
+  gzipStatic(false),
+  brotliStatic(false) {
     // support method
     this->limitExcept.push_back("GET");
     this->limitExcept.push_back("PUT");
@@ -23,16 +26,22 @@ LocationConfig::LocationConfig(const ServerConfig& config):
   CommonConfig(config),
   alias(DEFAULT_ALIAS),
   path(DEFAULT_PATH),
+  matchType(PREFIX),
   _return(std::make_pair(-1, "")),
-  autoindex(DEFAULT_AUTOINDEX) {}
+  autoindex(DEFAULT_AUTOINDEX),
+  gzipStatic(false),
+  brotliStatic(false) {}
 
 LocationConfig::LocationConfig(const LocationConfig& obj):
   CommonConfig(obj),
   alias(obj.getAlias()),
   path(obj.getPath()),
+  matchType(obj.getMatchType()),
   limitExcept(obj.getLimitExcept()),
   _return(obj.getReturn()),
   autoindex(obj.isAutoindex()),
+  gzipStatic(obj.isGzipStatic()),
+  brotliStatic(obj.isBrotliStatic()),
   locations(obj.getLocationConfig()) {}
 
 LocationConfig::~LocationConfig() {}
@@ -43,12 +52,19 @@ LocationConfig& LocationConfig::operator=(const LocationConfig& obj) {
     this->root = obj.getRoot();
     this->errorPage = obj.getErrorPage();
     this->index = obj.getIndex();
+    this->gzip = obj.isGzip();
+    this->gzipTypes = obj.getGzipTypes();
+    this->gzipMinLength = obj.getGzipMinLength();
+    this->gzipCompLevel = obj.getGzipCompLevel();
 
     this->alias = obj.getAlias();
     this->path = obj.getPath();
+    this->matchType = obj.getMatchType();
     this->limitExcept = obj.getLimitExcept();
     this->_return = obj.getReturn();
     this->autoindex = obj.isAutoindex();
+    this->gzipStatic = obj.isGzipStatic();
+    this->brotliStatic = obj.isBrotliStatic();
     this->locations = obj.getLocationConfig();
   }
 
@@ -57,9 +73,13 @@ LocationConfig& LocationConfig::operator=(const LocationConfig& obj) {
 
 // getter
 
-std::string LocationConfig::getAlias() const { return this->alias; }
+const std::string& LocationConfig::getAlias() const { return this->alias; }
 
-std::string LocationConfig::getPath() const { return this->path; }
+const std::string& LocationConfig::getPath() const { return this->path; }
+
+LocationConfig::MatchType LocationConfig::getMatchType() const { return this->matchType; }
+
+bool LocationConfig::isRegex() const { return this->matchType == REGEX || this->matchType == REGEX_CASELESS; }
 
 const std::vector<std::string>& LocationConfig::getLimitExcept() const {
   return this->limitExcept;
@@ -83,10 +103,14 @@ bool LocationConfig::hasReturn() const {
   return true;
 }
 
-std::pair<int, std::string> LocationConfig::getReturn() const { return this->_return; }
+const std::pair<int, std::string>& LocationConfig::getReturn() const { return this->_return; }
 
 bool LocationConfig::isAutoindex() const { return this->autoindex; }
 
+bool LocationConfig::isGzipStatic() const { return this->gzipStatic; }
+
+bool LocationConfig::isBrotliStatic() const { return this->brotliStatic; }
+
 const std::vector<LocationConfig>& LocationConfig::getLocationConfig() const {
   return this->locations;
 }
@@ -97,6 +121,8 @@ void LocationConfig::setAlias(std::string alias) { this->alias = alias; }
 
 void LocationConfig::setPath(std::string path) { this->path = path; }
 
+void LocationConfig::setMatchType(MatchType matchType) { this->matchType = matchType; }
+
 void LocationConfig::setLimitExcept(std::vector<std::string> methods) { this->limitExcept = methods; }
 
 void LocationConfig::setReturn(int status, std::string path) {
@@ -105,8 +131,14 @@ void LocationConfig::setReturn(int status, std::string path) {
 
 void LocationConfig::setAutoindex(bool autoIndex) { this->autoindex = autoIndex; }
 
+void LocationConfig::setGzipStatic(bool gzipStatic) { this->gzipStatic = gzipStatic; }
+
+void LocationConfig::setBrotliStatic(bool brotliStatic) { this->brotliStatic = brotliStatic; }
+
 void LocationConfig::addLocationConfig(LocationConfig location) { this->locations.push_back(location); }
 
+void LocationConfig::clearLocationConfig() { this->locations.clear(); }
+
 std::string LocationConfig::toStringLimitExcept() const {
   std::string ret;
 
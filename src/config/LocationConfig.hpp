@@ -11,27 +11,40 @@ class ServerConfig;
 
 class LocationConfig: public CommonConfig {
   public:
+    // location [=|^~|~|~*] path, ^~ keeps the prefix match over regex locations
+    enum MatchType { PREFIX, EXACT, PRIORITY_PREFIX, REGEX, REGEX_CASELESS };
+
     LocationConfig();
     LocationConfig(const ServerConfig& config);
     ~LocationConfig();
     LocationConfig(const LocationConfig& obj);
     LocationConfig& operator=(const LocationConfig& obj);
 
-    std::string                         getAlias() const;
-    std::string                         getPath() const;
+    const std::string&                  getAlias() const;
+    const std::string&                  getPath() const;
+    MatchType                           getMatchType() const;
+    // ~ and ~*, the path is then a pattern
+    bool                                isRegex() const;
     const std::vector<std::string>&     getLimitExcept() const;
     bool                                isMethodAllowed(std::string method) const;
     bool                                hasReturn() const;
-    std::pair<int, std::string>         getReturn() const;
+    const std::pair<int, std::string>&  getReturn() const;
     bool                                isAutoindex() const;
+    // Whether path.gz / path.br sidecars are served to clients that accept them
+    bool                                isGzipStatic() const;
+    bool                                isBrotliStatic() const;
     const std::vector<LocationConfig>&  getLocationConfig() const;
 
     void                                setAlias(std::string alias);
     void                                setPath(std::string path);
+    void                                setMatchType(MatchType matchType);
     void                                setLimitExcept(std::vector<std::string> methods);
     void                                setReturn(int status, std::string path);
     void                                setAutoindex(bool autoindex);
+    void                                setGzipStatic(bool gzipStatic);
+    void                                setBrotliStatic(bool brotliStatic);
     void                                addLocationConfig(LocationConfig location);
+    void                                clearLocationConfig();
 
     std::string                         toStringLimitExcept() const;
 
@@ -42,9 +55,12 @@ class LocationConfig: public CommonConfig {
 
     std::string                         alias;
     std::string                         path;
+    MatchType                           matchType;
     std::vector<std::string>            limitExcept;
     std::pair<int, std::string>         _return;
     bool                                autoindex;
+    bool                                gzipStatic;
+    bool                                brotliStatic;
     std::vector<LocationConfig>         locations;
 };
 
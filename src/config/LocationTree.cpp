@@ -0,0 +1,246 @@
+#include "./LocationTree.hpp"
+
+LocationTree::Node::Node(): prefix(-1), prefixDir(-1), exact(-1), exactDir(-1) {}
+
+LocationTree::LocationTree(): nodes(1) {}
+
+LocationTree::LocationTree(const LocationTree& obj):
+  nodes(obj.nodes),
+  table(obj.table),
+  regex(obj.regex),
+  regexLocations(obj.regexLocations) {}
+
+LocationTree::~LocationTree() {}
+
+LocationTree& LocationTree::operator=(const LocationTree& obj) {
+  if (this != &obj) {
+    this->nodes = obj.nodes;
+    this->table = obj.table;
+    this->regex = obj.regex;
+    this->regexLocations = obj.regexLocations;
+  }
+  return *this;
+}
+
+/*
+ * ==============================================
+ *                    Build
+ * ==============================================
+ */
+
+void LocationTree::compile(const std::vector<LocationConfig>& locations) {
+  this->nodes.assign(1, Node());
+  this->table.clear();
+  this->regex = RegexSet();
+  this->regexLocations.clear();
+
+  for (std::vector<LocationConfig>::const_iterator it = locations.begin(); it != locations.end(); ++it)
+    add(*it, "");
+  this->regex.compile();
+}
+
+// Nested paths are relative to their parent, the table keeps them flattened
+void LocationTree::add(const LocationConfig& location, const std::string& parent) {
+  std::string full = location.getPath();
+
+  // A pattern stands alone, nesting only passes the settings down
+  if (location.isRegex()) {
+    if (!location.getLocationConfig().empty())
+      throw std::runtime_error("location inside the regex location " + full);
+    this->regex.add(full, location.getMatchType() == LocationConfig::REGEX_CASELESS);
+    this->table.push_back(location);
+    this->regexLocations.push_back(this->table.size() - 1);
+    return;
+  }
+  if (full.empty() || full[0] != '/')
+    throw std::runtime_error("location path must start with '/': " + full);
+  if (!parent.empty())
+    full = parent.substr(0, parent.find_last_not_of('/') + 1) + full;
+
+  LocationConfig flat(location);
+  flat.setPath(full);
+  flat.clearLocationConfig();
+  this->table.push_back(flat);
+  insert(full, location.getMatchType(), this->table.size() - 1);
+
+  const std::vector<LocationConfig>& nested = location.getLocationConfig();
+  if (!nested.empty() && location.getMatchType() == LocationConfig::EXACT)
+    throw std::runtime_error("location inside the exact location " + full);
+  for (std::vector<LocationConfig>::const_iterator it = nested.begin(); it != nested.end(); ++it)
+    add(*it, full);
+}
+
+void LocationTree::insert(const std::string& path, LocationConfig::MatchType type, int index) {
+  size_t      begin = path.find_first_not_of('/');
+  size_t      end = path.find_last_not_of('/') + 1;
+  bool        dir = (begin != std::string::npos && end < path.length());
+  std::string key = (begin == std::string::npos) ? "" : path.substr(begin, end - begin);
+  int         node = 0;
+
+  while (!key.empty()) {
+    size_t seg = firstSegment(key.c_str(), key.length());
+    int    child = findChild(this->nodes[node], key.c_str(), seg);
+
+    if (child == -1) {
+      Node leaf;
+      leaf.label = key;
+      this->nodes.push_back(leaf);
+      child = this->nodes.size() - 1;
+
+      std::vector<int>& children = this->nodes[node].children;
+      std::vector<int>::iterator pos = children.begin();
+      while (pos != children.end()) {
+        const std::string& label = this->nodes[*pos].label;
+        if (compareSegment(label.c_str(), firstSegment(label.c_str(), label.length()), key.c_str(), seg) > 0)
+          break;
+        ++pos;
+      }
+      children.insert(pos, child);
+      node = child;
+      break;
+    }
+
+    // Longest run of whole segments shared with the edge
+    const std::string& label = this->nodes[child].label;
+    size_t common = seg;
+    while (common < label.length() && common < key.length() && label[common] == '/' && key[common] == '/') {
+      size_t next = common + 1 + firstSegment(label.c_str() + common + 1, label.length() - common - 1);
+      if (next > key.length() || label.compare(common, next - common, key, common, next - common) != 0
+          || (next < key.length() && key[next] != '/'))
+        break;
+      common = next;
+    }
+
+    if (common < label.length())
+      splitEdge(child, common);
+    node = child;
+    key.erase(0, common < key.length() ? common + 1 : common);
+  }
+
+  Node& target = this->nodes[node];
+  int&  slot = (type != LocationConfig::EXACT) ? (dir ? target.prefixDir : target.prefix)
+                                                : (dir ? target.exactDir : target.exact);
+  if (slot != -1)
+    throw std::runtime_error("duplicate location " + path);
+  slot = index;
+}
+
+// Cuts the edge into node at the '/' on offset at, node keeps its place under its parent
+void LocationTree::splitEdge(int node, size_t at) {
+  Node tail;
+
+  tail.label = this->nodes[node].label.substr(at + 1);
+  tail.children.swap(this->nodes[node].children);
+  tail.prefix = this->nodes[node].prefix;
+  tail.prefixDir = this->nodes[node].prefixDir;
+  tail.exact = this->nodes[node].exact;
+  tail.exactDir = this->nodes[node].exactDir;
+  this->nodes.push_back(tail);
+
+  Node& head = this->nodes[node];
+  head.label.erase(at);
+  head.children.assign(1, this->nodes.size() - 1);
+  head.prefix = -1;
+  head.prefixDir = -1;
+  head.exact = -1;
+  head.exactDir = -1;
+}
+
+/*
+ * ==============================================
+ *                    Lookup
+ * ==============================================
+ */
+
+const LocationConfig* LocationTree::find(const std::string& path) const {
+  int best = findPrefix(path);
+  int pattern;
+
+  if (best != -1 && this->table[best].getMatchType() != LocationConfig::PREFIX)
+    return &this->table[best];
+  if ((pattern = this->regex.match(path.c_str(), path.length())) != -1)
+    return &this->table[this->regexLocations[pattern]];
+  return (best == -1) ? NULL : &this->table[best];
+}
+
+// Index of the exact location of path, else of its deepest prefix location, -1 without any
+int LocationTree::findPrefix(const std::string& path) const {
+  const char* s = path.c_str();
+  size_t      len = path.length();
+  size_t      pos = 1;
+  const Node* node = &this->nodes[0];
+  int         best = node->prefix;
+
+  if (len == 0 || s[0] != '/')
+    return -1;
+  if (len == 1 && node->exact != -1)
+    return node->exact;
+
+  while (pos < len) {
+    int child = findChild(*node, s + pos, firstSegment(s + pos, len - pos));
+    if (child == -1)
+      break;
+
+    const std::string& label = this->nodes[child].label;
+    if (label.length() > len - pos || std::memcmp(label.c_str(), s + pos, label.length()) != 0)
+      break;
+    pos += label.length();
+    if (pos < len && s[pos] != '/')
+      break;
+
+    node = &this->nodes[child];
+    if (pos == len && node->exact != -1)
+      return node->exact;
+    if (pos + 1 == len && node->exactDir != -1)
+      return node->exactDir;
+    if (node->prefix != -1)
+      best = node->prefix;
+    // The longer of the two when the URI has the '/'
+    if (pos < len && node->prefixDir != -1)
+      best = node->prefixDir;
+    ++pos;
+  }
+
+  return best;
+}
+
+const std::vector<LocationConfig>& LocationTree::getLocations() const { return this->table; }
+
+int LocationTree::findChild(const Node& node, const char* seg, size_t len) const {
+  size_t low = 0;
+  size_t high = node.children.size();
+
+  while (low < high) {
+    size_t             mid = (low + high) / 2;
+    const std::string& label = this->nodes[node.children[mid]].label;
+    int                cmp = compareSegment(label.c_str(), firstSegment(label.c_str(), label.length()), seg, len);
+
+    if (cmp == 0)
+      return node.children[mid];
+    if (cmp < 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return -1;
+}
+
+/*
+ * ==============================================
+ *                    Utility
+ * ==============================================
+ */
+
+size_t LocationTree::firstSegment(const char* s, size_t len) {
+  const void* slash = std::memchr(s, '/', len);
+
+  return slash ? static_cast<const char*>(slash) - s : len;
+}
+
+int LocationTree::compareSegment(const char* a, size_t alen, const char* b, size_t blen) {
+  int cmp = std::memcmp(a, b, alen < blen ? alen : blen);
+
+  if (cmp != 0)
+    return cmp;
+  return (alen < blen) ? -1 : (alen > blen);
+}
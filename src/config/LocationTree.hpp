@@ -0,0 +1,70 @@
+#ifndef LOCATION_TREE_HPP
+# define LOCATION_TREE_HPP
+
+# include "./LocationConfig.hpp"
+# include "../etc/RegexSet.hpp"
+
+# include <cstring>
+# include <stdexcept>
+# include <string>
+# include <vector>
+
+/*
+ * The locations of one server, compiled at load into a radix tree over
+ * path segments. An edge holds one or more whole segments, nested blocks
+ * are flattened under their full path, a trailing '/' is kept on the
+ * node as a location of its own. find() walks the URI once in
+ * place: an exact (=) location answers only where the URI ends, otherwise
+ * the deepest prefix location passed on the way is remembered. Unless
+ * that one is ^~, the regex (~, ~*) locations come next, all of them in
+ * a single RegexSet where the first in config order wins, and the prefix
+ * location only when no regex matches.
+ */
+class LocationTree {
+  public:
+    LocationTree();
+    LocationTree(const LocationTree& obj);
+    ~LocationTree();
+    LocationTree&                 operator=(const LocationTree& obj);
+
+    // Throws std::runtime_error on a duplicate location, one nested in an exact or
+    // regex location, or a bad regex
+    void                          compile(const std::vector<LocationConfig>& locations);
+    // NULL when no location applies to path
+    const LocationConfig*         find(const std::string& path) const;
+    // Every location find() may answer, flattened
+    const std::vector<LocationConfig>& getLocations() const;
+
+  private:
+    struct Node {
+      // Segments from the parent on, without the leading '/'
+      std::string                 label;
+      // Children ordered by the first segment of their label
+      std::vector<int>            children;
+      int                         prefix;
+      // /dir/, the URI goes on with a '/' after the label
+      int                         prefixDir;
+      int                         exact;
+      // = /dir/, the URI ends with a '/' right after the label
+      int                         exactDir;
+
+      Node();
+    };
+
+    std::vector<Node>             nodes;
+    std::vector<LocationConfig>   table;
+    // Pattern i is the location table[regexLocations[i]]
+    RegexSet                      regex;
+    std::vector<int>              regexLocations;
+
+    void                          add(const LocationConfig& location, const std::string& parent);
+    void                          insert(const std::string& path, LocationConfig::MatchType type, int index);
+    int                           findPrefix(const std::string& path) const;
+    int                           findChild(const Node& node, const char* seg, size_t len) const;
+    void                          splitEdge(int node, size_t at);
+
+    static size_t                 firstSegment(const char* s, size_t len);
+    static int                    compareSegment(const char* a, size_t alen, const char* b, size_t blen);
+};
+
+#endif
@@ -37,9 +37,13 @@ ServerConfig::ServerConfig(const ServerConfig& obj):
   keepalive_requests(obj.getKeepAliveRequests()),
   port(obj.getPort()),
   host(obj.getHost()),
-  serverName(obj.getServerName()),
+  serverNames(obj.getServerNames()),
   cgi(obj.getCGI()),
-  locations(obj.getLocationConfig()) {}
+  locations(obj.getLocationConfig()),
+  locationTree(obj.locationTree),
+  defaultLocation(obj.defaultLocation),
+  cgiMatch(obj.cgiMatch),
+  cgiEntries(obj.cgiEntries) {}
 
 ServerConfig& ServerConfig::operator=(const ServerConfig& obj) {
   if (this != &obj) {
@@ -47,6 +51,10 @@ ServerConfig& ServerConfig::operator=(const ServerConfig& obj) {
     this->root = obj.getRoot();
     this->errorPage = obj.getErrorPage();
     this->index = obj.getIndex();
+    this->gzip = obj.isGzip();
+    this->gzipTypes = obj.getGzipTypes();
+    this->gzipMinLength = obj.getGzipMinLength();
+    this->gzipCompLevel = obj.getGzipCompLevel();
 
     this->gateway_timeout = obj.getGatewayTimeout();
     this->session_timeout = obj.getSessionTimeout();
@@ -54,59 +62,39 @@ ServerConfig& ServerConfig::operator=(const ServerConfig& obj) {
     this->keepalive_requests = obj.getKeepAliveRequests();
     this->port = obj.getPort();
     this->host = obj.getHost();
-    this->serverName = obj.getServerName();
+    this->serverNames = obj.getServerNames();
     this->cgi = obj.getCGI();
     this->locations = obj.getLocationConfig();
+    this->locationTree = obj.locationTree;
+    this->defaultLocation = obj.defaultLocation;
+    this->cgiMatch = obj.cgiMatch;
+    this->cgiEntries = obj.cgiEntries;
   }
   return *this;
 }
 
-const LocationConfig ServerConfig::findLocationConfig(std::string path) const {
-  size_t      pos;
-  std::string origin = path;
-  bool        end = false;
+const LocationConfig& ServerConfig::findLocationConfig(const std::string& path) const {
+  const LocationConfig* location = this->locationTree.find(path);
 
-  while ((pos = path.rfind('/')) != std::string::npos) {
-
-    for (std::vector<LocationConfig>::const_iterator it = this->locations.begin(); it != this->locations.end(); ++it) {
-      if (path == it->getPath()) return findLocationConfigRoop(*it, origin.substr(path.length()));
-    }
-
-    if (end == true) break;
-
-    path = path.erase(pos);
-
-    if (path.size() == 0) {
-      end = true;
-      path = "/";
-    }
-  }
-
-  return LocationConfig(*this);
+  return location ? *location : this->defaultLocation;
 }
 
-const LocationConfig& ServerConfig::findLocationConfigRoop(const LocationConfig& config, std::string path) const {
-  size_t      pos;
-  std::string origin = path;
-  bool        end = false;
-
-  while ((pos = path.rfind('/')) != std::string::npos) {
-
-    for (std::vector<LocationConfig>::const_iterator it = config.getLocationConfig().begin(); it != config.getLocationConfig().end(); ++it) {
-      if (path == it->getPath()) return findLocationConfigRoop(*it, origin.substr(path.length()));
-    }
+const std::pair<std::string, std::string>* ServerConfig::findCGI(const std::string& path) const {
+  int i = this->cgiMatch.match(path.c_str(), path.length());
 
-    if (end == true) break;
-
-    path = path.erase(pos);
+  return (i == -1) ? NULL : &this->cgiEntries[i];
+}
 
-    if (path.size() == 0) {
-      end = true;
-      path = "/";
-    }
-  }
+void ServerConfig::compile() {
+  this->locationTree.compile(this->locations);
+  this->defaultLocation = LocationConfig(*this);
 
-  return config;
+  // One scan finds the extension the old loop of finds stopped at
+  this->cgiMatch = RegexSet();
+  this->cgiEntries.assign(this->cgi.begin(), this->cgi.end());
+  for (size_t i = 0; i < this->cgiEntries.size(); ++i)
+    this->cgiMatch.add(RegexSet::escape(this->cgiEntries[i].first), false);
+  this->cgiMatch.compile();
 }
 
 // getter
@@ -121,14 +109,24 @@ int ServerConfig::getKeepAliveRequests() const { return this->keepalive_requests
 
 short ServerConfig::getPort() const { return this->port; }
 
-std::string ServerConfig::getHost() const { return this->host; }
+const std::string& ServerConfig::getHost() const { return this->host; }
+
+const std::string& ServerConfig::getServerName() const {
+  static const std::string none;
 
-std::string ServerConfig::getServerName() const { return this->serverName; }
+  return this->serverNames.empty() ? none : this->serverNames[0];
+}
+
+const std::vector<std::string>& ServerConfig::getServerNames() const { return this->serverNames; }
 
 const std::map<std::string, std::string>& ServerConfig::getCGI() const { return this->cgi; }
 
 const std::vector<LocationConfig>& ServerConfig::getLocationConfig() const { return this->locations; }
 
+const std::vector<LocationConfig>& ServerConfig::getCompiledLocations() const { return this->locationTree.getLocations(); }
+
+const LocationConfig& ServerConfig::getDefaultLocation() const { return this->defaultLocation; }
+
 // setter
 
 void ServerConfig::setGatewayTimeout(int n) { this->gateway_timeout = n; }
@@ -143,7 +141,7 @@ void ServerConfig::setPort(short port) { this->port = port; }
 
 void ServerConfig::setHost(std::string host) { this->host = host; }
 
-void ServerConfig::setServerName(std::string serverName) { this->serverName = serverName; }
+void ServerConfig::addServerName(const std::string& serverName) { this->serverNames.push_back(serverName); }
 
 void ServerConfig::insertCGI(std::string ext, std::string path) { this->cgi.insert(std::make_pair(ext, path)); }
 
@@ -3,6 +3,8 @@
 
 # include "./CommonConfig.hpp"
 # include "./LocationConfig.hpp"
+# include "./LocationTree.hpp"
+# include "../etc/RegexSet.hpp"
 
 # include <string>
 # include <vector>
@@ -17,17 +19,25 @@ class ServerConfig: public CommonConfig {
     ~ServerConfig();
     ServerConfig& operator=(const ServerConfig& obj);
 
-    const LocationConfig                      findLocationConfig(std::string path) const;
+    // The location serving path, the server defaults when none matches
+    const LocationConfig&                     findLocationConfig(const std::string& path) const;
+    // The first cgi entry, in extension order, whose extension occurs in path; NULL without any
+    const std::pair<std::string, std::string>* findCGI(const std::string& path) const;
 
     int                                       getGatewayTimeout() const;
     int                                       getSessionTimeout() const;
     int                                       getKeepAliveTimeout() const;
     int                                       getKeepAliveRequests() const;
     short                                     getPort() const;
-    std::string                               getHost() const;
-    std::string                               getServerName() const;
+    const std::string&                        getHost() const;
+    // The first server_name, "" without any
+    const std::string&                        getServerName() const;
+    const std::vector<std::string>&           getServerNames() const;
     const std::map<std::string, std::string>& getCGI() const;
     const std::vector<LocationConfig>&        getLocationConfig() const;
+    // What findLocationConfig() answers with: the compiled locations and the server default
+    const std::vector<LocationConfig>&        getCompiledLocations() const;
+    const LocationConfig&                     getDefaultLocation() const;
 
     void                                      setGatewayTimeout(int n);
     void                                      setSessionTimeout(int n);
@@ -35,9 +45,11 @@ class ServerConfig: public CommonConfig {
     void                                      setKeepAliveRequests(int n);
     void                                      setPort(short port);
     void                                      setHost(std::string host);
-    void                                      setServerName(std::string serverName);
+    void                                      addServerName(const std::string& serverName);
     void                                      insertCGI(std::string ext, std::string path);
     void                                      addLocationConfig(LocationConfig location);
+    // Builds the location and cgi matchers, once the server block is fully parsed
+    void                                      compile();
 
   private:
     static const int                          DEFAULT_GATEWAY_TIMEOUT;
@@ -53,11 +65,14 @@ class ServerConfig: public CommonConfig {
     int                                       keepalive_requests;
     short                                     port;
     std::string                               host;
-    std::string                               serverName;
+    std::vector<std::string>                  serverNames;
     std::map<std::string, std::string>        cgi;
     std::vector<LocationConfig>               locations;
-
-    const LocationConfig&                     findLocationConfigRoop(const LocationConfig& config, std::string path) const;
+    LocationTree                              locationTree;
+    LocationConfig                            defaultLocation;
+    // Pattern i is the escaped extension of cgiEntries[i]
+    RegexSet                                  cgiMatch;
+    std::vector<std::pair<std::string, std::string> > cgiEntries;
 };
 
 #endif
@@ -0,0 +1,197 @@
+#include "./VirtualHosts.hpp"
+#include "./ServerConfig.hpp"
+
+VirtualHosts::VirtualHosts() {}
+
+VirtualHosts::VirtualHosts(const VirtualHosts& obj): listens(obj.listens), groups(obj.groups) {}
+
+VirtualHosts::~VirtualHosts() {}
+
+VirtualHosts& VirtualHosts::operator=(const VirtualHosts& obj) {
+  if (this != &obj) {
+    this->listens = obj.listens;
+    this->groups = obj.groups;
+  }
+  return *this;
+}
+
+/*
+ * ==============================================
+ *                    Build
+ * ==============================================
+ */
+
+void VirtualHosts::compile(const std::vector<ServerConfig>& servers) {
+  this->listens.clear();
+  this->groups.clear();
+
+  for (size_t i = 0; i < servers.size(); ++i) {
+    in_addr_t addr;
+    size_t    g = 0;
+
+    // The listener binds to any address when the host doesn't parse
+    if (inet_pton(AF_INET, servers[i].getHost().c_str(), &addr) != 1)
+      addr = htonl(INADDR_ANY);
+    while (g < this->groups.size() && (this->groups[g].addr != addr || this->groups[g].port != servers[i].getPort()))
+      ++g;
+    if (g == this->groups.size()) {
+      Group group;
+      group.addr = addr;
+      group.port = servers[i].getPort();
+      group.defaultServer = i;
+      this->groups.push_back(group);
+      this->listens.push_back(std::make_pair(servers[i].getHost(), servers[i].getPort()));
+    }
+
+    const std::vector<std::string>& names = servers[i].getServerNames();
+    for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+      addName(this->groups[g], *it, i);
+  }
+}
+
+void VirtualHosts::addName(Group& group, const std::string& name, int server) {
+  std::string key;
+  NameTable*  table = &group.exact;
+  size_t      star = name.find('*');
+
+  for (size_t i = 0; i < name.length(); ++i)
+    key += static_cast<char>(std::tolower(static_cast<unsigned char>(name[i])));
+  if (star != std::string::npos) {
+    if (name.find('*', star + 1) != std::string::npos || name.length() < 3)
+      throw std::runtime_error("server_name wildcard error: " + name);
+    if (name.compare(0, 2, "*.") == 0) {
+      table = &group.leading;
+      key.erase(0, 2);
+    }
+    else if (name.compare(name.length() - 2, 2, ".*") == 0) {
+      table = &group.trailing;
+      key.erase(key.length() - 2);
+    }
+    else
+      throw std::runtime_error("server_name wildcard error: " + name);
+  }
+
+  if (!table->insert(key, server))
+    throw std::runtime_error("duplicate server_name " + name);
+}
+
+/*
+ * ==============================================
+ *                    Lookup
+ * ==============================================
+ */
+
+const std::vector<std::pair<std::string, short> >& VirtualHosts::getListens() const { return this->listens; }
+
+int VirtualHosts::findListen(in_addr_t addr, short port) const {
+  int any = -1;
+
+  for (size_t g = 0; g < this->groups.size(); ++g) {
+    if (this->groups[g].port != port)
+      continue;
+    if (this->groups[g].addr == addr)
+      return g;
+    if (this->groups[g].addr == htonl(INADDR_ANY))
+      any = g;
+  }
+  return any;
+}
+
+int VirtualHosts::find(int listen, const char* host, size_t len) const {
+  if (listen < 0 || static_cast<size_t>(listen) >= this->groups.size())
+    return 0;
+
+  const Group& group = this->groups[listen];
+  const char*  end;
+  int          server;
+
+  // Drop the port and a trailing dot, [v6] literals keep their colons
+  if (len > 0 && host[0] == '[')
+    end = static_cast<const char*>(std::memchr(host, ']', len));
+  else
+    end = static_cast<const char*>(std::memchr(host, ':', len));
+  if (end != NULL)
+    len = end - host + (host[0] == '[');
+  if (len > 0 && host[len - 1] == '.')
+    --len;
+  if (len == 0)
+    return group.defaultServer;
+
+  if ((server = group.exact.find(host, len)) != -1)
+    return server;
+  for (size_t i = 0; i < len; ++i)
+    if (host[i] == '.' && (server = group.leading.find(host + i + 1, len - i - 1)) != -1)
+      return server;
+  for (size_t i = len; i > 0; --i)
+    if (host[i - 1] == '.' && (server = group.trailing.find(host, i - 1)) != -1)
+      return server;
+  return group.defaultServer;
+}
+
+/*
+ * ==============================================
+ *                  Name table
+ * ==============================================
+ */
+
+VirtualHosts::NameTable::NameTable(): count(0) {}
+
+bool VirtualHosts::NameTable::insert(const std::string& key, int value) {
+  if (find(key.c_str(), key.length()) != -1)
+    return false;
+  if ((this->count + 1) * 2 > this->keys.size())
+    grow();
+
+  size_t mask = this->keys.size() - 1;
+  size_t i = hash(key.c_str(), key.length()) & mask;
+  while (this->values[i] != -1)
+    i = (i + 1) & mask;
+  this->keys[i] = key;
+  this->values[i] = value;
+  ++this->count;
+  return true;
+}
+
+int VirtualHosts::NameTable::find(const char* s, size_t len) const {
+  if (this->count == 0)
+    return -1;
+
+  size_t mask = this->keys.size() - 1;
+  for (size_t i = hash(s, len) & mask; this->values[i] != -1; i = (i + 1) & mask) {
+    const std::string& key = this->keys[i];
+    size_t             j = 0;
+
+    if (key.length() != len)
+      continue;
+    while (j < len && static_cast<unsigned char>(key[j]) == std::tolower(static_cast<unsigned char>(s[j])))
+      ++j;
+    if (j == len)
+      return this->values[i];
+  }
+  return -1;
+}
+
+void VirtualHosts::NameTable::grow() {
+  std::vector<std::string> oldKeys;
+  std::vector<int>         oldValues;
+
+  oldKeys.swap(this->keys);
+  oldValues.swap(this->values);
+  this->keys.resize(oldKeys.empty() ? 8 : oldKeys.size() * 2);
+  this->values.assign(this->keys.size(), -1);
+  this->count = 0;
+  for (size_t i = 0; i < oldKeys.size(); ++i)
+    if (oldValues[i] != -1)
+      insert(oldKeys[i], oldValues[i]);
+}
+
+// FNV-1a over the lower-cased bytes
+size_t VirtualHosts::NameTable::hash(const char* s, size_t len) {
+  size_t h = 2166136261u;
+
+  for (size_t i = 0; i < len; ++i) {
+    h ^= static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(s[i])));
+    h *= 16777619u;
+  }
+  return h;
+}
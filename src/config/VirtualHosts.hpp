@@ -0,0 +1,76 @@
+#ifndef VIRTUAL_HOSTS_HPP
+# define VIRTUAL_HOSTS_HPP
+
+# include <arpa/inet.h>
+# include <cctype>
+# include <cstring>
+# include <stdexcept>
+# include <string>
+# include <utility>
+# include <vector>
+
+class ServerConfig;
+
+/*
+ * Host routing of the http block, compiled once the servers are parsed.
+ * Servers are grouped by their listen address, the first of a group is
+ * its default. Inside a group the names sit in three hash tables: exact
+ * names, *.suffix names and prefix.* names. A lookup hashes the Host as
+ * is, then the suffixes behind each dot from the longest, then the
+ * prefixes before each dot from the longest, so its cost depends on the
+ * labels of the Host, never on the number of servers.
+ */
+class VirtualHosts {
+  public:
+    VirtualHosts();
+    VirtualHosts(const VirtualHosts& obj);
+    ~VirtualHosts();
+    VirtualHosts&                 operator=(const VirtualHosts& obj);
+
+    // Throws std::runtime_error on a name given twice on one address, or a misplaced '*'
+    void                          compile(const std::vector<ServerConfig>& servers);
+
+    // One entry per distinct listen address, in the order of the config
+    const std::vector<std::pair<std::string, short> >& getListens() const;
+    // Group of a local address as getsockname() reports it, -1 when none listens there
+    int                           findListen(in_addr_t addr, short port) const;
+    // Index into the servers, the default of the group when no name matches
+    int                           find(int listen, const char* host, size_t len) const;
+
+  private:
+    // Open addressing, keys stored lower case and matched case-insensitively
+    class NameTable {
+      public:
+        NameTable();
+
+        bool                      insert(const std::string& key, int value);
+        // -1 when missing
+        int                       find(const char* s, size_t len) const;
+
+      private:
+        std::vector<std::string>  keys;
+        std::vector<int>          values;
+        size_t                    count;
+
+        void                      grow();
+        static size_t             hash(const char* s, size_t len);
+    };
+
+    struct Group {
+      in_addr_t                   addr;
+      short                       port;
+      int                         defaultServer;
+      NameTable                   exact;
+      // *.example.com, keyed on example.com
+      NameTable                   leading;
+      // www.*, keyed on www
+      NameTable                   trailing;
+    };
+
+    std::vector<std::pair<std::string, short> > listens;
+    std::vector<Group>            groups;
+
+    void                          addName(Group& group, const std::string& name, int server);
+};
+
+#endif
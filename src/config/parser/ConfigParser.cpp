@@ -1,5 +1,7 @@
 #include "./ConfigParser.hpp"
 
+const int ConfigParser::MAX_INCLUDE_DEPTH = 16;
+
 ConfigParser::ConfigParser() {
   pos = 0;
 };
@@ -12,6 +14,8 @@ Config ConfigParser::parse(const std::string& fileName) {
   generateToken(fileName);
   while (curToken().isNot(Token::END_OF_FILE)) {
     if (curToken().is(Token::HTTP)) conf.setHttpConfig(parseHttp());
+    else if (curToken().is(Token::WORKER_PROCESSES)) parseWorkerProcesses(conf);
+    else if (curToken().is(Token::WORKER_THREADS)) parseWorkerThreads(conf);
     else throwBadSyntax();
     nextToken();
   }
@@ -32,11 +36,23 @@ HttpConfig ConfigParser::parseHttp() {
     else if (curToken().is(Token::CLIENT_HEADER_TIMEOUT)) parseClientHeaderTimeout(conf);
     else if (curToken().is(Token::CLIENT_BODY_TIMEOUT)) parseClientBodyTimeout(conf);
     else if (curToken().is(Token::SEND_TIMEOUT)) parseSendTimeout(conf);
+    else if (curToken().is(Token::IO_ENGINE)) parseIoEngine(conf);
+    else if (curToken().is(Token::OPEN_FILE_CACHE)) parseOpenFileCache(conf);
+    else if (curToken().is(Token::OPEN_FILE_CACHE_VALID)) parseOpenFileCacheValid(conf);
+    else if (curToken().is(Token::FILE_CACHE)) parseFileCache(conf);
+    else if (curToken().is(Token::NEGATIVE_CACHE)) parseNegativeCache(conf);
+    else if (curToken().is(Token::TYPES)) parseTypes(conf);
     else if (curToken().isCommon()) parseCommon(conf);
     else throwBadSyntax();
   }
   expectCurToken(Token::RBRACE);
 
+  try {
+    conf.compileServers();
+  } catch (const std::runtime_error& e) {
+    throwError(e.what());
+  }
+
   return conf;
 }
 
@@ -58,14 +74,19 @@ ServerConfig ConfigParser::parseServer(HttpConfig& httpConf) {
   }
   expectCurToken(Token::RBRACE);
 
+  try {
+    conf.compile();
+  } catch (const std::runtime_error& e) {
+    throwError(e.what());
+  }
+
   return conf;
 }
 
 LocationConfig ConfigParser::parseLocation(ServerConfig& serverConf) {
   LocationConfig conf(serverConf);
 
-  expectNextToken(Token::IDENT);
-  conf.setPath(curToken().getLiteral());
+  parseLocationPath(conf);
   expectNextToken(Token::LBRACE);
   for (nextToken(); curToken().isNot(Token::END_OF_FILE) && curToken().isNot(Token::RBRACE); nextToken()) {
     if (curToken().is(Token::LOCATION)) conf.addLocationConfig(parseLocation(conf));
@@ -73,6 +94,8 @@ LocationConfig ConfigParser::parseLocation(ServerConfig& serverConf) {
     else if (curToken().is(Token::ALIAS)) parseAlias(conf);
     else if (curToken().is(Token::LIMIT_EXCEPT)) parseLimitExcept(conf);
     else if (curToken().is(Token::AUTOINDEX)) parseAutoindex(conf);
+    else if (curToken().is(Token::GZIP_STATIC)) parseGzipStatic(conf);
+    else if (curToken().is(Token::BROTLI_STATIC)) parseBrotliStatic(conf);
     else if (curToken().is(Token::RETURN)) parseReturn(conf);
     else throwBadSyntax();
   }
@@ -84,8 +107,9 @@ LocationConfig ConfigParser::parseLocation(ServerConfig& serverConf) {
 LocationConfig ConfigParser::parseLocation(LocationConfig& locationConf) {
   LocationConfig conf(locationConf);
 
-  expectNextToken(Token::IDENT);
-  conf.setPath(curToken().getLiteral());
+  conf.clearLocationConfig();
+  conf.setMatchType(LocationConfig::PREFIX);
+  parseLocationPath(conf);
   expectNextToken(Token::LBRACE);
   for (nextToken(); curToken().isNot(Token::END_OF_FILE) && curToken().isNot(Token::RBRACE); nextToken()) {
     if (curToken().is(Token::LOCATION)) conf.addLocationConfig(parseLocation(conf));
@@ -93,6 +117,8 @@ LocationConfig ConfigParser::parseLocation(LocationConfig& locationConf) {
     else if (curToken().is(Token::ALIAS)) parseAlias(conf);
     else if (curToken().is(Token::LIMIT_EXCEPT)) parseLimitExcept(conf);
     else if (curToken().is(Token::AUTOINDEX)) parseAutoindex(conf);
+    else if (curToken().is(Token::GZIP_STATIC)) parseGzipStatic(conf);
+    else if (curToken().is(Token::BROTLI_STATIC)) parseBrotliStatic(conf);
     else if (curToken().is(Token::RETURN)) parseReturn(conf);
     else throwBadSyntax();
   }
@@ -106,6 +132,42 @@ void ConfigParser::parseCommon(CommonConfig& conf) {
   else if (curToken().is(Token::ERROR_PAGE)) parseErrorPage(conf);
   else if (curToken().is(Token::CLIENT_MAX_BODY_SIZE)) parseClientMaxBodySize(conf);
   else if (curToken().is(Token::INDEX)) parseIndex(conf);
+  else if (curToken().is(Token::GZIP)) parseGzip(conf);
+  else if (curToken().is(Token::GZIP_TYPES)) parseGzipTypes(conf);
+  else if (curToken().is(Token::GZIP_MIN_LENGTH)) parseGzipMinLength(conf);
+  else if (curToken().is(Token::GZIP_COMP_LEVEL)) parseGzipCompLevel(conf);
+}
+
+// main
+// main
+// main
+
+// worker_processes [count(int)/auto(ident)];
+void ConfigParser::parseWorkerProcesses(Config& conf) {
+  nextToken();
+  if (curToken().is(Token::INT))
+    conf.setWorkerProcesses(atoi(curToken().getLiteral()));
+  else if (curToken().is(Token::IDENT) && curToken().getLiteral() == "auto") {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    conf.setWorkerProcesses(cpus > 0 ? cpus : 1);
+  }
+  else
+    throwError("worker_processes error");
+  expectNextToken(Token::SEMICOLON);
+}
+
+// worker_threads [count(int)/auto(ident)];
+void ConfigParser::parseWorkerThreads(Config& conf) {
+  nextToken();
+  if (curToken().is(Token::INT))
+    conf.setWorkerThreads(atoi(curToken().getLiteral()));
+  else if (curToken().is(Token::IDENT) && curToken().getLiteral() == "auto") {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    conf.setWorkerThreads(cpus > 0 ? cpus : 1);
+  }
+  else
+    throwError("worker_threads error");
+  expectNextToken(Token::SEMICOLON);
 }
 
 // http
@@ -133,6 +195,106 @@ void ConfigParser::parseSendTimeout(HttpConfig& conf) {
   expectNextToken(Token::SEMICOLON);
 }
 
+// io_engine [epoll(ident)/io_uring(ident)/select(ident)];
+void ConfigParser::parseIoEngine(HttpConfig& conf) {
+  expectNextToken(Token::IDENT);
+  std::string engine = curToken().getLiteral();
+  if (engine != "epoll" && engine != "io_uring" && engine != "select")
+    throwError("io_engine error");
+  conf.setIoEngine(engine);
+  expectNextToken(Token::SEMICOLON);
+}
+
+// open_file_cache [max entries(int)] [inactive second(int)] / off(ident);
+void ConfigParser::parseOpenFileCache(HttpConfig& conf) {
+  nextToken();
+  if (curToken().is(Token::IDENT) && curToken().getLiteral() == "off") {
+    conf.setOpenFileCache(0, conf.getOpenFileCacheInactive());
+    expectNextToken(Token::SEMICOLON);
+    return;
+  }
+  if (curToken().isNot(Token::INT))
+    throwError("open_file_cache error");
+  int max = atoi(curToken().getLiteral());
+  int inactive = conf.getOpenFileCacheInactive();
+  if (peekToken().is(Token::INT)) {
+    nextToken();
+    inactive = atoi(curToken().getLiteral());
+  }
+  conf.setOpenFileCache(max, inactive);
+  expectNextToken(Token::SEMICOLON);
+}
+
+// open_file_cache_valid [second(int)];
+void ConfigParser::parseOpenFileCacheValid(HttpConfig& conf) {
+  expectNextToken(Token::INT);
+  conf.setOpenFileCacheValid(atoi(curToken().getLiteral()));
+  expectNextToken(Token::SEMICOLON);
+}
+
+// file_cache [memory byte(int)] [max file size byte(int)] / off(ident);
+void ConfigParser::parseFileCache(HttpConfig& conf) {
+  nextToken();
+  if (curToken().is(Token::IDENT) && curToken().getLiteral() == "off") {
+    conf.setFileCache(0, conf.getFileCacheMaxFileSize());
+    expectNextToken(Token::SEMICOLON);
+    return;
+  }
+  if (curToken().isNot(Token::INT))
+    throwError("file_cache error");
+  int budget = atoi(curToken().getLiteral());
+  int max_file_size = conf.getFileCacheMaxFileSize();
+  if (peekToken().is(Token::INT)) {
+    nextToken();
+    max_file_size = atoi(curToken().getLiteral());
+  }
+  conf.setFileCache(budget, max_file_size);
+  expectNextToken(Token::SEMICOLON);
+}
+
+// negative_cache [max entries(int)] [valid second(int)] / off(ident);
+void ConfigParser::parseNegativeCache(HttpConfig& conf) {
+  nextToken();
+  if (curToken().is(Token::IDENT) && curToken().getLiteral() == "off") {
+    conf.setNegativeCache(0, conf.getNegativeCacheValid());
+    expectNextToken(Token::SEMICOLON);
+    return;
+  }
+  if (curToken().isNot(Token::INT))
+    throwError("negative_cache error");
+  int max = atoi(curToken().getLiteral());
+  int valid = conf.getNegativeCacheValid();
+  if (peekToken().is(Token::INT)) {
+    nextToken();
+    valid = atoi(curToken().getLiteral());
+  }
+  conf.setNegativeCache(max, valid);
+  expectNextToken(Token::SEMICOLON);
+}
+
+// types { [MIME type(ident)] [extension(ident) ...]; ... }
+void ConfigParser::parseTypes(HttpConfig& conf) {
+  std::vector<std::pair<std::string, std::string> > types;
+
+  expectNextToken(Token::LBRACE);
+  for (nextToken(); curToken().isNot(Token::END_OF_FILE) && curToken().isNot(Token::RBRACE); nextToken()) {
+    expectCurToken(Token::IDENT);
+    std::string type = curToken().getLiteral();
+    if (type.find('/') == std::string::npos)
+      throwError("types error");
+    // An extension may read as a number or a keyword, 123 or cgi
+    while (peekToken().isNot(Token::SEMICOLON) && peekToken().isNot(Token::END_OF_FILE)) {
+      nextToken();
+      if (curToken().is(Token::LBRACE) || curToken().is(Token::RBRACE) || curToken().is(Token::ILLEGAL))
+        throwBadSyntax();
+      types.push_back(std::make_pair(curToken().getLiteral(), type));
+    }
+    expectNextToken(Token::SEMICOLON);
+  }
+  expectCurToken(Token::RBRACE);
+  conf.addTypes(types);
+}
+
 // server
 // server
 // server
@@ -175,10 +337,14 @@ void ConfigParser::parseListen(ServerConfig& conf) {
   expectNextToken(Token::SEMICOLON);
 }
 
-// server_name [path(ident)];
+// server_name [name(ident) ...];
 void ConfigParser::parseServerName(ServerConfig& conf) {
   expectNextToken(Token::IDENT);
-  conf.setServerName(curToken().getLiteral());
+  conf.addServerName(curToken().getLiteral());
+  while (peekToken().is(Token::IDENT)) {
+    nextToken();
+    conf.addServerName(curToken().getLiteral());
+  }
   expectNextToken(Token::SEMICOLON);
 }
 
@@ -186,6 +352,36 @@ void ConfigParser::parseServerName(ServerConfig& conf) {
 // location
 // location
 
+// location [=/^~/~/~*(ident)] [path(ident)/regex(ident)]
+void ConfigParser::parseLocationPath(LocationConfig& conf) {
+  expectNextToken(Token::IDENT);
+  std::string path = curToken().getLiteral();
+
+  if (path == "=" || path == "^~" || path == "~" || path == "~*") {
+    expectNextToken(Token::IDENT);
+    path += curToken().getLiteral();
+  }
+  if (path.compare(0, 2, "~*") == 0 || path.compare(0, 1, "~") == 0) {
+    conf.setMatchType(path.compare(0, 2, "~*") == 0 ? LocationConfig::REGEX_CASELESS : LocationConfig::REGEX);
+    path.erase(0, conf.getMatchType() == LocationConfig::REGEX_CASELESS ? 2 : 1);
+    if (path.empty())
+      throwError("empty location regex");
+    conf.setPath(path);
+    return;
+  }
+  if (path.compare(0, 1, "=") == 0) {
+    conf.setMatchType(LocationConfig::EXACT);
+    path.erase(0, 1);
+  }
+  else if (path.compare(0, 2, "^~") == 0) {
+    conf.setMatchType(LocationConfig::PRIORITY_PREFIX);
+    path.erase(0, 2);
+  }
+  if (path.empty() || path[0] != '/')
+    throwError("location path must start with '/'");
+  conf.setPath(path);
+}
+
 void ConfigParser::parseAlias(LocationConfig& conf) {
   expectNextToken(Token::IDENT);
   conf.setAlias(curToken().getLiteral());
@@ -226,6 +422,24 @@ void ConfigParser::parseAutoindex(LocationConfig& conf) {
   expectNextToken(Token::SEMICOLON);
 }
 
+// gzip_static [on(ident)/off(ident)]
+void ConfigParser::parseGzipStatic(LocationConfig& conf) {
+  expectNextToken(Token::IDENT);
+  if (curToken().getLiteral() == "on") conf.setGzipStatic(true);
+  else if (curToken().getLiteral() == "off") conf.setGzipStatic(false);
+  else throwError("gzip_static error");
+  expectNextToken(Token::SEMICOLON);
+}
+
+// brotli_static [on(ident)/off(ident)]
+void ConfigParser::parseBrotliStatic(LocationConfig& conf) {
+  expectNextToken(Token::IDENT);
+  if (curToken().getLiteral() == "on") conf.setBrotliStatic(true);
+  else if (curToken().getLiteral() == "off") conf.setBrotliStatic(false);
+  else throwError("brotli_static error");
+  expectNextToken(Token::SEMICOLON);
+}
+
 // return [HTTP status code(int)] [URI(ident)]
 void ConfigParser::parseReturn(LocationConfig& conf) {
   expectNextToken(Token::INT);
@@ -279,24 +493,97 @@ void ConfigParser::parseIndex(CommonConfig& conf) {
   expectNextToken(Token::SEMICOLON);
 }
 
+// gzip [on(ident)/off(ident)]
+void ConfigParser::parseGzip(CommonConfig& conf) {
+  expectNextToken(Token::IDENT);
+  if (curToken().getLiteral() == "on") conf.setGzip(true);
+  else if (curToken().getLiteral() == "off") conf.setGzip(false);
+  else throwError("gzip error");
+  expectNextToken(Token::SEMICOLON);
+}
+
+// gzip_types [MIME type(ident) ...]
+void ConfigParser::parseGzipTypes(CommonConfig& conf) {
+  std::vector<std::string> types;
+
+  expectNextToken(Token::IDENT);
+  types.push_back(curToken().getLiteral());
+  while (peekToken().is(Token::IDENT)) {
+    nextToken();
+    types.push_back(curToken().getLiteral());
+  }
+  conf.setGzipTypes(types);
+  expectNextToken(Token::SEMICOLON);
+}
+
+// gzip_min_length [length(int)]
+void ConfigParser::parseGzipMinLength(CommonConfig& conf) {
+  expectNextToken(Token::INT);
+  conf.setGzipMinLength(atoi(curToken().getLiteral()));
+  expectNextToken(Token::SEMICOLON);
+}
+
+// gzip_comp_level [level(int)]
+void ConfigParser::parseGzipCompLevel(CommonConfig& conf) {
+  expectNextToken(Token::INT);
+  int level = atoi(curToken().getLiteral());
+  if (level < 1 || level > 9)
+    throwError("gzip_comp_level must be between 1 and 9");
+  conf.setGzipCompLevel(level);
+  expectNextToken(Token::SEMICOLON);
+}
+
 void ConfigParser::generateToken(std::string fileName) {
-  size_t        lineCount = 1;
-  Lexer         lexer;
-  Token         token;
-  std::string   line;
-  std::ifstream fileIn(fileName.c_str(), std::ifstream::in);
+  Token eof(Token::END_OF_FILE, "END_OF_FILE");
 
   this->fileName = fileName;
-  if (!fileIn.is_open())
-    throw std::runtime_error("config file open failed");
+  readTokens(fileName, NULL, 0);
+  eof.setFileName(fileName);
+  tokens.push_back(eof);
+}
+
+// include [path(ident)];
+// The tokens of fileName, each include replaced by the tokens of its file.
+// A relative path is taken from the directory of the including file.
+void ConfigParser::readTokens(const std::string& fileName, const Token* include, int depth) {
+  size_t              lineCount = 1;
+  Lexer               lexer;
+  Token               token;
+  std::string         line;
+  std::vector<Token>  read;
+  std::ifstream       fileIn(fileName.c_str(), std::ifstream::in);
+
+  if (!fileIn.is_open()) {
+    if (include == NULL)
+      throw std::runtime_error("config file open failed");
+    throw std::runtime_error(errorPrefix(*include) + "include file open failed \'" + fileName + "\'");
+  }
   for (;!std::getline(fileIn, line).eof(); ++lineCount) {
     lexer.setInput(line);
     while ((token = lexer.nextToken()).isNot(Token::END_OF_FILE)) {
+      token.setFileName(fileName);
       token.setLineNumber(lineCount);
-      tokens.push_back(token);
+      read.push_back(token);
     }
   }
-  tokens.push_back(Token(Token::END_OF_FILE, "END_OF_FILE"));
+
+  for (size_t i = 0; i < read.size(); ++i) {
+    if (read[i].isNot(Token::INCLUDE)) {
+      tokens.push_back(read[i]);
+      continue;
+    }
+    if (i + 2 >= read.size() || read[i + 1].isNot(Token::IDENT) || read[i + 2].isNot(Token::SEMICOLON))
+      throw std::runtime_error(errorPrefix(read[i]) + "include error");
+    if (depth >= MAX_INCLUDE_DEPTH)
+      throw std::runtime_error(errorPrefix(read[i]) + "include nested too deep");
+
+    std::string path = read[i + 1].getLiteral();
+    size_t      slash = fileName.rfind('/');
+    if (!path.empty() && path[0] != '/' && slash != std::string::npos)
+      path = fileName.substr(0, slash + 1) + path;
+    readTokens(path, &read[i], depth + 1);
+    i += 2;
+  }
 }
 
 void ConfigParser::nextToken() {
@@ -328,7 +615,13 @@ void ConfigParser::expectCurToken(const std::string& expected) const {
 }
 
 std::string ConfigParser::errorPrefix() const {
-  return this->fileName + " " + util::itoa(curToken().getLineNumber()) + ":" + util::itoa(curToken().getPos()) + " ";
+  return errorPrefix(curToken());
+}
+
+std::string ConfigParser::errorPrefix(const Token& token) const {
+  std::string file = token.getFileName().empty() ? this->fileName : token.getFileName();
+
+  return file + " " + util::itoa(token.getLineNumber()) + ":" + util::itoa(token.getPos()) + " ";
 }
 
 void ConfigParser::throwError(const std::string& desc) const {
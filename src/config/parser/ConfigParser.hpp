@@ -19,6 +19,8 @@ class ConfigParser {
     Config                    parse(const std::string &fileName);
 
   private:
+    static const int          MAX_INCLUDE_DEPTH;
+
     unsigned long             pos;
     std::vector<Token>        tokens;
     std::string               fileName;
@@ -29,11 +31,20 @@ class ConfigParser {
     LocationConfig            parseLocation(LocationConfig& conf);
     void                      parseCommon(CommonConfig& conf);
 
+    // main
+    void                      parseWorkerProcesses(Config& conf);
+    void                      parseWorkerThreads(Config& conf);
 
     // http
     void                      parseClientHeaderTimeout(HttpConfig& conf);
     void                      parseClientBodyTimeout(HttpConfig& conf);
     void                      parseSendTimeout(HttpConfig& conf);
+    void                      parseIoEngine(HttpConfig& conf);
+    void                      parseOpenFileCache(HttpConfig& conf);
+    void                      parseOpenFileCacheValid(HttpConfig& conf);
+    void                      parseFileCache(HttpConfig& conf);
+    void                      parseNegativeCache(HttpConfig& conf);
+    void                      parseTypes(HttpConfig& conf);
 
     // server
     void                      parseGatewayTimeout(ServerConfig& conf);
@@ -44,17 +55,25 @@ class ConfigParser {
     void                      parseServerName(ServerConfig& conf);
     void                      parseCGI(ServerConfig& conf);
     // location
+    void                      parseLocationPath(LocationConfig& conf);
     void                      parseAlias(LocationConfig& conf);
     void                      parseLimitExcept(LocationConfig& conf);
     void                      parseAutoindex(LocationConfig& conf);
+    void                      parseGzipStatic(LocationConfig& conf);
+    void                      parseBrotliStatic(LocationConfig& conf);
     void                      parseReturn(LocationConfig& conf);
     // common
     void                      parseRoot(CommonConfig& conf);
     void                      parseErrorPage(CommonConfig& conf);
     void                      parseClientMaxBodySize(CommonConfig& conf);
     void                      parseIndex(CommonConfig& conf);
+    void                      parseGzip(CommonConfig& conf);
+    void                      parseGzipTypes(CommonConfig& conf);
+    void                      parseGzipMinLength(CommonConfig& conf);
+    void                      parseGzipCompLevel(CommonConfig& conf);
 
     void                      generateToken(std::string fileName);
+    void                      readTokens(const std::string& fileName, const Token* include, int depth);
 
     void                      nextToken();
     Token                     curToken() const;
@@ -62,6 +81,7 @@ class ConfigParser {
     void                      expectNextToken(const std::string& expected);
     void                      expectCurToken(const std::string& expected) const;
     std::string               errorPrefix() const;
+    std::string               errorPrefix(const Token& token) const;
     void                      throwError(const std::string& desc) const;
     void                      throwExpectError(const std::string& expected) const;
     void                      throwBadSyntax() const;
@@ -69,8 +69,20 @@ std::string Lexer::readWord() {
   return input.substr(begin_pos, position - begin_pos);
 }
 
+// "..." is one word as is, for the ;, { and } of a regex
+bool Lexer::readQuoted(std::string& word) {
+  size_t end = input.find('"', read_position);
+
+  if (end == std::string::npos)
+    return false;
+  word = input.substr(read_position, end - read_position);
+  read_position = end + 1;
+  readChar();
+  return true;
+}
+
 bool Lexer::isWord(char ch) const {
-  if (ch != '\0' && (std::isalnum(ch) || strchr("_.:/-", ch)))
+  if (ch != '\0' && (std::isalnum(ch) || strchr("_.:/-*=^~\\()|$[]+?,", ch)))
     return true;
   return false;
 }
@@ -113,6 +125,17 @@ Token Lexer::nextToken() {
     case 0:
       ret = Token(Token::END_OF_FILE, std::string(""));
       break;
+    case '"': {
+      std::string word;
+      if (!readQuoted(word))
+        ret = Token(Token::ILLEGAL, std::string(1, ch));
+      else {
+        ret = Token(Token::IDENT, word);
+        ret.setPos(beginPosition);
+        return ret;
+      }
+      break;
+    }
     default:
       if (isWord(ch)) {
         std::string word = readWord();
@@ -28,6 +28,7 @@ class Lexer {
     void          readChar();
     char          peekChar();
     std::string   readWord();
+    bool          readQuoted(std::string& word);
     bool          isWord(char ch) const;
     bool          isWordNumber(const std::string &s) const;
     std::string   lookupIdent(std::string ident);
@@ -29,6 +29,21 @@ const std::string Token::SEND_TIMEOUT             = "send_timeout";
 const std::string Token::KEEPALIVE_TIMEOUT        = "keepalive_timeout";
 const std::string Token::KEEPALIVE_REQUESTS       = "keepalive_requests";
 const std::string Token::GATEWAY_TIMEOUT          = "gateway_timeout";
+const std::string Token::IO_ENGINE                = "io_engine";
+const std::string Token::WORKER_PROCESSES         = "worker_processes";
+const std::string Token::WORKER_THREADS           = "worker_threads";
+const std::string Token::OPEN_FILE_CACHE          = "open_file_cache";
+const std::string Token::OPEN_FILE_CACHE_VALID    = "open_file_cache_valid";
+const std::string Token::FILE_CACHE               = "file_cache";
+const std::string Token::NEGATIVE_CACHE           = "negative_cache";
+const std::string Token::GZIP_STATIC              = "gzip_static";
+const std::string Token::BROTLI_STATIC            = "brotli_static";
+const std::string Token::GZIP                     = "gzip";
+const std::string Token::GZIP_TYPES               = "gzip_types";
+const std::string Token::GZIP_MIN_LENGTH          = "gzip_min_length";
+const std::string Token::GZIP_COMP_LEVEL          = "gzip_comp_level";
+const std::string Token::INCLUDE                  = "include";
+const std::string Token::TYPES                    = "types";
 
 const int         Token::IDENT_IDX                = 0;
 const int         Token::TYPE_IDX                 = 1;
@@ -55,6 +70,21 @@ const std::string Token::keyword[Token::KEYWORD_SIZE][2] = {
   {"keepalive_timeout",                          Token::KEEPALIVE_TIMEOUT},
   {"keepalive_requests",                         Token::KEEPALIVE_REQUESTS},
   {"gateway_timeout",                            Token::GATEWAY_TIMEOUT},
+  {"io_engine",                                  Token::IO_ENGINE},
+  {"worker_processes",                           Token::WORKER_PROCESSES},
+  {"worker_threads",                             Token::WORKER_THREADS},
+  {"open_file_cache",                            Token::OPEN_FILE_CACHE},
+  {"open_file_cache_valid",                      Token::OPEN_FILE_CACHE_VALID},
+  {"file_cache",                                 Token::FILE_CACHE},
+  {"negative_cache",                             Token::NEGATIVE_CACHE},
+  {"gzip_static",                                Token::GZIP_STATIC},
+  {"brotli_static",                              Token::BROTLI_STATIC},
+  {"gzip",                                       Token::GZIP},
+  {"gzip_types",                                 Token::GZIP_TYPES},
+  {"gzip_min_length",                            Token::GZIP_MIN_LENGTH},
+  {"gzip_comp_level",                            Token::GZIP_COMP_LEVEL},
+  {"include",                                    Token::INCLUDE},
+  {"types",                                      Token::TYPES},
 };
 
 Token::Token():
@@ -64,6 +94,7 @@ Token::Token():
   literal("undefined") {}
 
 Token::Token(const Token &obj):
+  fileName(obj.fileName),
   lineNumber(obj.lineNumber),
   pos(obj.getPos()),
   type(obj.getType()),
@@ -79,6 +110,7 @@ Token::~Token() {}
 
 Token &Token::operator=(const Token& obj) {
   if (this != &obj) {
+    this->fileName = obj.fileName;
     this->lineNumber = obj.getLineNumber();
     this->pos = obj.getPos();
     this->type = obj.getType();
@@ -103,7 +135,11 @@ bool Token::isCommon() const {
   if (is(ROOT) ||
       is(CLIENT_MAX_BODY_SIZE) ||
       is(ERROR_PAGE) ||
-      is(INDEX))
+      is(INDEX) ||
+      is(GZIP) ||
+      is(GZIP_TYPES) ||
+      is(GZIP_MIN_LENGTH) ||
+      is(GZIP_COMP_LEVEL))
     return true;
   return false;
 }
@@ -118,6 +154,10 @@ std::string Token::getLiteral() const {
   return this->literal;
 }
 
+std::string Token::getFileName() const {
+  return this->fileName;
+}
+
 size_t Token::getLineNumber() const {
   return this->lineNumber;
 }
@@ -136,6 +176,10 @@ void Token::setLiteral(const std::string& literal) {
   this->literal = literal;
 }
 
+void Token::setFileName(const std::string& fileName) {
+  this->fileName = fileName;
+}
+
 void Token::setLineNumber(size_t lineNumber) {
   this->lineNumber = lineNumber;
 }
@@ -17,11 +17,13 @@ class Token {
 
     std::string               getType() const;
     std::string               getLiteral() const;
+    std::string               getFileName() const;
     size_t                    getLineNumber() const;
     size_t                    getPos() const;
 
     void                      setType(const std::string& type);
     void                      setLiteral(const std::string& type);
+    void                      setFileName(const std::string& fileName);
     void                      setLineNumber(size_t lineNumber);
     void                      setPos(size_t pos);
 
@@ -54,13 +56,30 @@ class Token {
     static const std::string  KEEPALIVE_TIMEOUT;
     static const std::string  KEEPALIVE_REQUESTS;
     static const std::string  GATEWAY_TIMEOUT;
+    static const std::string  IO_ENGINE;
+    static const std::string  WORKER_PROCESSES;
+    static const std::string  WORKER_THREADS;
+    static const std::string  OPEN_FILE_CACHE;
+    static const std::string  OPEN_FILE_CACHE_VALID;
+    static const std::string  FILE_CACHE;
+    static const std::string  NEGATIVE_CACHE;
+    static const std::string  GZIP_STATIC;
+    static const std::string  BROTLI_STATIC;
+    static const std::string  GZIP;
+    static const std::string  GZIP_TYPES;
+    static const std::string  GZIP_MIN_LENGTH;
+    static const std::string  GZIP_COMP_LEVEL;
+    static const std::string  INCLUDE;
+    static const std::string  TYPES;
 
-    enum { KEYWORD_SIZE = 21 };
+    enum { KEYWORD_SIZE = 36 };
     static const int          IDENT_IDX;
     static const int          TYPE_IDX;
     static const std::string  keyword[KEYWORD_SIZE][2];
 
   private:
+    // The file the token was read from, include splices in others
+    std::string fileName;
     size_t      lineNumber;
     size_t      pos;
     std::string type;
@@ -0,0 +1,42 @@
+#include "./Deflater.hpp"
+
+Deflater::Deflater(): active(false) {}
+
+Deflater::~Deflater() {
+  if (this->active)
+    deflateEnd(&this->stream);
+}
+
+bool Deflater::init(int level) {
+  this->stream.zalloc = Z_NULL;
+  this->stream.zfree = Z_NULL;
+  this->stream.opaque = Z_NULL;
+  // 15 + 16 asks for the gzip wrapper instead of the zlib one
+  this->active = deflateInit2(&this->stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+  return this->active;
+}
+
+void Deflater::update(const char* data, size_t length, std::string& out) {
+  run(data, length, Z_NO_FLUSH, out);
+}
+
+void Deflater::finish(std::string& out) {
+  run(NULL, 0, Z_FINISH, out);
+  deflateEnd(&this->stream);
+  this->active = false;
+}
+
+void Deflater::run(const char* data, size_t length, int flush, std::string& out) {
+  char chunk[1024 * 16];
+
+  if (!this->active)
+    return;
+  this->stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  this->stream.avail_in = length;
+  do {
+    this->stream.next_out = reinterpret_cast<Bytef*>(chunk);
+    this->stream.avail_out = sizeof(chunk);
+    deflate(&this->stream, flush);
+    out.append(chunk, sizeof(chunk) - this->stream.avail_out);
+  } while (this->stream.avail_out == 0);
+}
@@ -0,0 +1,31 @@
+#ifndef DEFLATER_HPP
+# define DEFLATER_HPP
+
+# include <string>
+# include <zlib.h>
+
+/*
+ * A gzip stream fed a piece at a time. update() appends whatever zlib
+ * had ready to out, finish() flushes the rest and the gzip trailer.
+ */
+class Deflater {
+  public:
+    Deflater();
+    ~Deflater();
+
+    // false when zlib can't set the stream up, level is 1 to 9
+    bool                  init(int level);
+    void                  update(const char* data, size_t length, std::string& out);
+    void                  finish(std::string& out);
+
+  private:
+    z_stream              stream;
+    bool                  active;
+
+    void                  run(const char* data, size_t length, int flush, std::string& out);
+
+    Deflater(const Deflater& obj);
+    Deflater&             operator=(const Deflater& obj);
+};
+
+#endif
@@ -2,14 +2,37 @@
 
 std::string logger::endl = "\n";
 
+logger::LineBuffer::LineBuffer() {
+  pthread_key_create(&this->key, destroy);
+}
+
+logger::LineBuffer::~LineBuffer() {
+  pthread_key_delete(this->key);
+}
+
+std::string& logger::LineBuffer::get() {
+  std::string* buf = static_cast<std::string*>(pthread_getspecific(this->key));
+
+  if (buf == NULL) {
+    buf = new std::string();
+    pthread_setspecific(this->key, buf);
+  }
+  return *buf;
+}
+
+void logger::LineBuffer::destroy(void* p) {
+  delete static_cast<std::string*>(p);
+}
+
 std::string logger::timestamp() {
   std::string ret;
   time_t      cur_time;
   char        buf[100];
 
   cur_time = time(NULL);
-  tm *time = localtime(&cur_time);
-  strftime(buf, 100, "%d/%b/%Y:%X %Z", time);
+  tm time;
+  localtime_r(&cur_time, &time);
+  strftime(buf, 100, "%d/%b/%Y:%X %Z", &time);
 
   ret = buf;
   ret = std::string(CYAN) + "[" + ret + "]" + std::string(RESET);
@@ -19,167 +42,160 @@ std::string logger::timestamp() {
 
 logger::Error& logger::Error::operator<<(std::string s) {
   if (s == logger::endl) {
-    std::cout << timestamp()
-      << std::string(RED) + "[ERROR] " << this->buf << std::string(RESET) << std::endl;
-    this->buf = "";
-    this->buf.reserve();
+    // One write per line, so lines of different threads don't interleave
+    std::cout << timestamp() + std::string(RED) + "[ERROR] " + this->buf.get() + std::string(RESET) + "\n" << std::flush;
+    this->buf.get() = "";
 
   }
   else
-    this->buf += s;
+    this->buf.get() += s;
 
   return *this;
 }
 
 logger::Error& logger::Error::operator<<(int s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Error& logger::Error::operator<<(size_t s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Error& logger::Error::operator<<(unsigned int s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Error& logger::Error::operator<<(short s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Error& logger::Error::operator<<(unsigned short s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Warning& logger::Warning::operator<<(std::string s) {
   if (s == logger::endl) {
-    std::cout << timestamp()
-      << std::string(YELLOW) + "[WARNING] " << this->buf << std::string(RESET) << std::endl;
-    this->buf = "";
-    this->buf.reserve();
+    std::cout << timestamp() + std::string(YELLOW) + "[WARNING] " + this->buf.get() + std::string(RESET) + "\n" << std::flush;
+    this->buf.get() = "";
   }
   else
-    this->buf += s;
+    this->buf.get() += s;
 
   return *this;
 }
 
 logger::Warning& logger::Warning::operator<<(int s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Warning& logger::Warning::operator<<(size_t s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Warning& logger::Warning::operator<<(unsigned int s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Warning& logger::Warning::operator<<(short s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Info& logger::Info::operator<<(std::string s) {
   if (s == logger::endl) {
-    std::cout << timestamp()
-      << std::string(GREEN) + "[INFO] " << this->buf << std::string(RESET) << std::endl;
-    this->buf = "";
-    this->buf.reserve();
+    std::cout << timestamp() + std::string(GREEN) + "[INFO] " + this->buf.get() + std::string(RESET) + "\n" << std::flush;
+    this->buf.get() = "";
   }
   else
-    this->buf += s;
+    this->buf.get() += s;
 
   return *this;
 }
 
 logger::Info& logger::Info::operator<<(int s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Info& logger::Info::operator<<(size_t s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Info& logger::Info::operator<<(unsigned int s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Info& logger::Info::operator<<(short s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Info& logger::Info::operator<<(unsigned short s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Debug& logger::Debug::operator<<(std::string s) {
   if (s == logger::endl) {
-    std::cout << timestamp()
-      << std::string(WHITE) + "[DEBUG] " << this->buf << std::string(RESET) << std::endl;
-    this->buf = "";
-    this->buf.reserve();
+    std::cout << timestamp() + std::string(WHITE) + "[DEBUG] " + this->buf.get() + std::string(RESET) + "\n" << std::flush;
+    this->buf.get() = "";
   }
   else
-    this->buf += s;
+    this->buf.get() += s;
 
   return *this;
 }
 
 logger::Debug& logger::Debug::operator<<(int s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Debug& logger::Debug::operator<<(size_t s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Debug& logger::Debug::operator<<(unsigned int s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Debug& logger::Debug::operator<<(short s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
 
 logger::Debug& logger::Debug::operator<<(unsigned short s) {
-  this->buf += util::itoa(s);
+  this->buf.get() += util::itoa(s);
 
   return *this;
 }
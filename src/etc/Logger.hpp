@@ -2,6 +2,7 @@
 # define LOGGER_HPP
 
 # include <iostream>
+# include <pthread.h>
 # include "./Util.hpp"
 
 # define RESET "\033[0;0m"
@@ -17,6 +18,19 @@ namespace logger {
   extern std::string endl;
   std::string timestamp();
 
+  // Line being built by the calling thread
+  class LineBuffer {
+    public:
+      LineBuffer();
+      ~LineBuffer();
+      std::string&  get();
+
+    private:
+      pthread_key_t key;
+
+      static void   destroy(void* p);
+  };
+
   class Error {
     public:
       Error& operator<<(std::string s);
@@ -27,7 +41,7 @@ namespace logger {
       Error& operator<<(unsigned short s);
 
     private:
-      std::string buf;
+      LineBuffer buf;
   };
   class Warning {
     public:
@@ -39,7 +53,7 @@ namespace logger {
       Warning& operator<<(unsigned short s);
 
     private:
-      std::string buf;
+      LineBuffer buf;
   };
   class Info {
     public:
@@ -51,7 +65,7 @@ namespace logger {
       Info& operator<<(unsigned short s);
 
     private:
-      std::string buf;
+      LineBuffer buf;
   };
   class Debug {
     public:
@@ -63,7 +77,7 @@ namespace logger {
       Debug& operator<<(unsigned short s);
 
     private:
-      std::string buf;
+      LineBuffer buf;
   };
 
   extern Info info;
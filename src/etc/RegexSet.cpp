@@ -0,0 +1,617 @@
+#include "./RegexSet.hpp"
+
+const size_t  RegexSet::MAX_DFA_STATES = 4096;
+const int     RegexSet::MAX_REPEAT = 100;
+
+RegexSet::RegexSet():
+  patterns(0),
+  dfa(false),
+  classes(0),
+  restartMatch(INT_MAX),
+  restartMatchEnd(INT_MAX),
+  acceptEmpty(INT_MAX),
+  source(NULL),
+  cursor(0),
+  caseless(false) {}
+
+RegexSet::RegexSet(const RegexSet& obj):
+  nfa(obj.nfa),
+  starts(obj.starts),
+  patterns(obj.patterns),
+  dfa(obj.dfa),
+  classes(obj.classes),
+  classOf(obj.classOf),
+  restart(obj.restart),
+  restartStep(obj.restartStep),
+  restartMatch(obj.restartMatch),
+  restartMatchEnd(obj.restartMatchEnd),
+  initial(obj.initial),
+  table(obj.table),
+  accept(obj.accept),
+  acceptEnd(obj.acceptEnd),
+  acceptEmpty(obj.acceptEmpty),
+  source(NULL),
+  cursor(0),
+  caseless(false) {}
+
+RegexSet::~RegexSet() {}
+
+RegexSet& RegexSet::operator=(const RegexSet& obj) {
+  if (this != &obj) {
+    this->nfa = obj.nfa;
+    this->starts = obj.starts;
+    this->patterns = obj.patterns;
+    this->dfa = obj.dfa;
+    this->classes = obj.classes;
+    this->classOf = obj.classOf;
+    this->restart = obj.restart;
+    this->restartStep = obj.restartStep;
+    this->restartMatch = obj.restartMatch;
+    this->restartMatchEnd = obj.restartMatchEnd;
+    this->initial = obj.initial;
+    this->table = obj.table;
+    this->accept = obj.accept;
+    this->acceptEnd = obj.acceptEnd;
+    this->acceptEmpty = obj.acceptEmpty;
+  }
+  return *this;
+}
+
+size_t RegexSet::size() const { return this->patterns; }
+
+std::string RegexSet::escape(const std::string& literal) {
+  std::string ret;
+
+  for (size_t i = 0; i < literal.length(); ++i) {
+    if (literal[i] != '\0' && std::strchr("\\.^$|()[]{}*+?", literal[i]))
+      ret += '\\';
+    ret += literal[i];
+  }
+  return ret;
+}
+
+/*
+ * ==============================================
+ *                    Parser
+ * ==============================================
+ */
+
+void RegexSet::add(const std::string& pattern, bool caseless) {
+  this->source = &pattern;
+  this->cursor = 0;
+  this->caseless = caseless;
+
+  if (pattern.empty())
+    throwSyntax("empty pattern");
+  Fragment fragment = parseAlternation();
+  if (this->cursor < pattern.length())
+    throwSyntax("unmatched )");
+
+  int match = newState(MATCH, -1, -1);
+  this->nfa[match].pattern = this->patterns++;
+  patch(fragment, match);
+  this->starts.push_back(fragment.start);
+  this->source = NULL;
+}
+
+RegexSet::Fragment RegexSet::parseAlternation() {
+  Fragment fragment = parseConcat();
+
+  while (this->cursor < this->source->length() && (*this->source)[this->cursor] == '|') {
+    ++this->cursor;
+    Fragment other = parseConcat();
+    fragment.start = newState(EPSILON, fragment.start, other.start);
+    fragment.outs.insert(fragment.outs.end(), other.outs.begin(), other.outs.end());
+  }
+  return fragment;
+}
+
+RegexSet::Fragment RegexSet::parseConcat() {
+  Fragment fragment;
+  bool     empty = true;
+
+  while (this->cursor < this->source->length()) {
+    char c = (*this->source)[this->cursor];
+    if (c == '|' || c == ')')
+      break;
+    Fragment next = parseRepeat();
+    fragment = empty ? next : concat(fragment, next);
+    empty = false;
+  }
+  if (empty) {
+    fragment.start = newState(EPSILON, -1, -1);
+    fragment.outs.push_back(std::make_pair(fragment.start, 0));
+  }
+  return fragment;
+}
+
+RegexSet::Fragment RegexSet::parseRepeat() {
+  const std::string& s = *this->source;
+  size_t             begin = this->cursor;
+  Fragment           fragment = parseAtom();
+
+  if (this->cursor >= s.length())
+    return fragment;
+
+  char c = s[this->cursor];
+  int  min;
+  int  max;
+  if (c == '*') { min = 0; max = -1; }
+  else if (c == '+') { min = 1; max = -1; }
+  else if (c == '?') { min = 0; max = 1; }
+  else if (c == '{' && this->cursor + 1 < s.length() && std::isdigit(static_cast<unsigned char>(s[this->cursor + 1]))) {
+    ++this->cursor;
+    min = max = parseNumber();
+    if (this->cursor < s.length() && s[this->cursor] == ',') {
+      ++this->cursor;
+      max = (this->cursor < s.length() && s[this->cursor] == '}') ? -1 : parseNumber();
+    }
+    if (this->cursor >= s.length() || s[this->cursor] != '}')
+      throwSyntax("missing }");
+    if (max > MAX_REPEAT || (max != -1 && max < min) || min > MAX_REPEAT)
+      throwSyntax("bad repeat count");
+  }
+  else
+    return fragment;
+  ++this->cursor;
+
+  // Lazy and greedy match the same subjects
+  if (this->cursor < s.length() && s[this->cursor] == '?')
+    ++this->cursor;
+  if (this->cursor < s.length() && (s[this->cursor] == '*' || s[this->cursor] == '+' || s[this->cursor] == '?'))
+    throwSyntax("nothing to repeat");
+
+  return repeat(fragment, begin, min, max);
+}
+
+// atom{min,max}, max -1 for no bound; the copies after first parse the atom at begin again
+RegexSet::Fragment RegexSet::repeat(const Fragment& first, size_t begin, int min, int max) {
+  int      copies = (max == -1) ? min + 1 : max;
+  Fragment result;
+
+  result.start = newState(EPSILON, -1, -1);
+  result.outs.push_back(std::make_pair(result.start, 0));
+  for (int i = 0; i < copies; ++i) {
+    Fragment copy = first;
+    if (i > 0) {
+      size_t saved = this->cursor;
+      this->cursor = begin;
+      copy = parseAtom();
+      this->cursor = saved;
+    }
+
+    if (i >= min) {
+      int split = newState(EPSILON, copy.start, -1);
+      if (max == -1) {
+        patch(copy, split);
+        copy.outs.clear();
+      }
+      copy.start = split;
+      copy.outs.push_back(std::make_pair(split, 1));
+    }
+    result = concat(result, copy);
+  }
+  return result;
+}
+
+RegexSet::Fragment RegexSet::parseAtom() {
+  const std::string&   s = *this->source;
+  unsigned char        c = s[this->cursor++];
+  std::bitset<SYMBOLS> on;
+
+  switch (c) {
+    case '(': {
+      if (s.compare(this->cursor, 2, "?:") == 0)
+        this->cursor += 2;
+      Fragment fragment = parseAlternation();
+      if (this->cursor >= s.length() || s[this->cursor] != ')')
+        throwSyntax("missing )");
+      ++this->cursor;
+      return fragment;
+    }
+    case '[':
+      parseClass(on);
+      break;
+    case '.':
+      for (int i = 0; i < 256; ++i)
+        on.set(i);
+      break;
+    case '^':
+      return anchor(AT_BEGIN);
+    case '$':
+      return anchor(AT_END);
+    case '\\':
+      parseEscape(on);
+      break;
+    case '*':
+    case '+':
+    case '?':
+      throwSyntax("nothing to repeat");
+      break;
+    default:
+      on.set(c);
+      fold(on);
+      break;
+  }
+  return single(on);
+}
+
+void RegexSet::parseClass(std::bitset<SYMBOLS>& on) {
+  const std::string& s = *this->source;
+  bool               negate = false;
+  bool               first = true;
+
+  if (this->cursor < s.length() && s[this->cursor] == '^') {
+    negate = true;
+    ++this->cursor;
+  }
+  while (true) {
+    if (this->cursor >= s.length())
+      throwSyntax("missing ]");
+
+    unsigned char lo = s[this->cursor];
+    if (lo == ']' && !first)
+      break;
+    first = false;
+    ++this->cursor;
+    if (lo == '\\') {
+      std::bitset<SYMBOLS> escaped;
+      parseEscape(escaped);
+      on |= escaped;
+      continue;
+    }
+    if (this->cursor + 1 < s.length() && s[this->cursor] == '-' && s[this->cursor + 1] != ']') {
+      unsigned char hi = s[this->cursor + 1];
+      if (hi < lo)
+        throwSyntax("bad range");
+      for (int i = lo; i <= hi; ++i)
+        on.set(i);
+      this->cursor += 2;
+    }
+    else
+      on.set(lo);
+  }
+  ++this->cursor;
+
+  fold(on);
+  if (negate)
+    for (int i = 0; i < 256; ++i)
+      on.flip(i);
+}
+
+void RegexSet::parseEscape(std::bitset<SYMBOLS>& on) {
+  const std::string& s = *this->source;
+
+  if (this->cursor >= s.length())
+    throwSyntax("trailing \\");
+
+  unsigned char c = s[this->cursor++];
+  bool          negate = (c == 'D' || c == 'W' || c == 'S');
+  switch (c) {
+    case 'd':
+    case 'D':
+      for (int i = '0'; i <= '9'; ++i) on.set(i);
+      break;
+    case 'w':
+    case 'W':
+      for (int i = 0; i < 256; ++i) if (std::isalnum(i) || i == '_') on.set(i);
+      break;
+    case 's':
+    case 'S':
+      for (const char* p = " \t\n\r\f\v"; *p; ++p) on.set(static_cast<unsigned char>(*p));
+      break;
+    case 'n': on.set('\n'); break;
+    case 't': on.set('\t'); break;
+    case 'r': on.set('\r'); break;
+    case 'f': on.set('\f'); break;
+    case 'v': on.set('\v'); break;
+    case 'x':
+      if (this->cursor + 2 > s.length() || !std::isxdigit(static_cast<unsigned char>(s[this->cursor])) || !std::isxdigit(static_cast<unsigned char>(s[this->cursor + 1])))
+        throwSyntax("bad \\x");
+      on.set(std::strtol(s.substr(this->cursor, 2).c_str(), NULL, 16));
+      this->cursor += 2;
+      break;
+    default:
+      // Only punctuation stands for itself, \b, \A or \1 would match wrong
+      if (!std::ispunct(c))
+        throwSyntax(std::string("unsupported escape \\") + static_cast<char>(c));
+      on.set(c);
+      break;
+  }
+  if (negate)
+    for (int i = 0; i < 256; ++i)
+      on.flip(i);
+}
+
+int RegexSet::parseNumber() {
+  const std::string& s = *this->source;
+  int                n = 0;
+  size_t             begin = this->cursor;
+
+  while (this->cursor < s.length() && std::isdigit(static_cast<unsigned char>(s[this->cursor])) && n <= MAX_REPEAT)
+    n = n * 10 + (s[this->cursor++] - '0');
+  if (this->cursor == begin)
+    throwSyntax("bad repeat count");
+  return n;
+}
+
+void RegexSet::fold(std::bitset<SYMBOLS>& on) const {
+  if (!this->caseless)
+    return;
+  for (int c = 'a'; c <= 'z'; ++c) {
+    if (on.test(c) || on.test(std::toupper(c))) {
+      on.set(c);
+      on.set(std::toupper(c));
+    }
+  }
+}
+
+void RegexSet::throwSyntax(const std::string& desc) const {
+  throw std::runtime_error("regex \"" + *this->source + "\": " + desc);
+}
+
+/*
+ * ==============================================
+ *                  NFA pieces
+ * ==============================================
+ */
+
+int RegexSet::newState(Kind kind, int out, int out1) {
+  State state;
+
+  state.kind = kind;
+  state.out = out;
+  state.out1 = out1;
+  state.pattern = -1;
+  this->nfa.push_back(state);
+  return this->nfa.size() - 1;
+}
+
+void RegexSet::patch(const Fragment& fragment, int target) {
+  for (size_t i = 0; i < fragment.outs.size(); ++i) {
+    State& state = this->nfa[fragment.outs[i].first];
+    (fragment.outs[i].second == 0 ? state.out : state.out1) = target;
+  }
+}
+
+RegexSet::Fragment RegexSet::anchor(Kind kind) {
+  Fragment fragment;
+
+  fragment.start = newState(kind, -1, -1);
+  fragment.outs.push_back(std::make_pair(fragment.start, 0));
+  return fragment;
+}
+
+RegexSet::Fragment RegexSet::single(const std::bitset<SYMBOLS>& on) {
+  Fragment fragment;
+
+  fragment.start = newState(SET, -1, -1);
+  this->nfa[fragment.start].on = on;
+  fragment.outs.push_back(std::make_pair(fragment.start, 0));
+  return fragment;
+}
+
+RegexSet::Fragment RegexSet::concat(const Fragment& a, const Fragment& b) {
+  Fragment fragment;
+
+  patch(a, b.start);
+  fragment.start = a.start;
+  fragment.outs = b.outs;
+  return fragment;
+}
+
+/*
+ * ==============================================
+ *                   Compile
+ * ==============================================
+ */
+
+void RegexSet::compile() {
+  std::vector<char> seen(this->nfa.size(), 0);
+  std::vector<int>  initial(this->starts);
+
+  this->restart = this->starts;
+  closure(this->restart, false, false, seen);
+  this->restartMatch = lowestMatch(this->restart);
+  this->restartMatchEnd = lowestMatchAtEnd(this->restart, false, seen);
+  closure(initial, true, false, seen);
+  this->acceptEmpty = lowestMatchAtEnd(initial, true, seen);
+  std::set_difference(initial.begin(), initial.end(), this->restart.begin(), this->restart.end(),
+    std::back_inserter(this->initial));
+
+  buildClasses();
+  this->restartStep.assign(this->classes, std::vector<int>());
+  for (int i = 0; i < SYMBOLS; ++i) {
+    std::vector<int>& next = this->restartStep[this->classOf[i]];
+    if (next.empty())
+      move(this->restart, i, next, seen);
+  }
+
+  this->dfa = buildDfa();
+  if (!this->dfa) {
+    this->table.clear();
+    this->accept.clear();
+    this->acceptEnd.clear();
+  }
+}
+
+// Bytes no pattern tells apart share a class, and a DFA column
+void RegexSet::buildClasses() {
+  this->classOf.assign(SYMBOLS, 0);
+  this->classes = 1;
+
+  std::set<std::string> done;
+  for (size_t s = 0; s < this->nfa.size(); ++s) {
+    if (this->nfa[s].kind != SET || !done.insert(this->nfa[s].on.to_string()).second)
+      continue;
+
+    // A class splits in two when the set holds some of its bytes only
+    std::vector<int> split(2 * SYMBOLS, -1);
+    int              count = 0;
+    for (int i = 0; i < SYMBOLS; ++i) {
+      int& id = split[2 * this->classOf[i] + this->nfa[s].on.test(i)];
+      if (id == -1)
+        id = count++;
+      this->classOf[i] = id;
+    }
+    this->classes = count;
+  }
+}
+
+// State 0 is the subject not started yet
+bool RegexSet::buildDfa() {
+  std::map<std::vector<int>, int> ids;
+  std::vector<std::vector<int> >  sets;
+  std::vector<char>               seen(this->nfa.size(), 0);
+  std::vector<int>                represent(this->classes, 0);
+  std::vector<int>                next;
+
+  for (int i = SYMBOLS - 1; i >= 0; --i)
+    represent[this->classOf[i]] = i;
+
+  this->table.clear();
+  this->accept.clear();
+  this->acceptEnd.clear();
+  sets.push_back(this->initial);
+  ids[this->initial] = 0;
+
+  for (size_t i = 0; i < sets.size(); ++i) {
+    std::vector<int> from = sets[i];
+
+    this->accept.push_back(std::min(lowestMatch(from), this->restartMatch));
+    this->acceptEnd.push_back(std::min(lowestMatchAtEnd(from, false, seen), this->restartMatchEnd));
+    for (int c = 0; c < this->classes; ++c) {
+      step(from, represent[c], next, seen);
+
+      std::map<std::vector<int>, int>::iterator it = ids.find(next);
+      if (it == ids.end()) {
+        if (sets.size() >= MAX_DFA_STATES)
+          return false;
+        it = ids.insert(std::make_pair(next, static_cast<int>(sets.size()))).first;
+        sets.push_back(next);
+      }
+      this->table.push_back(it->second);
+    }
+  }
+  return true;
+}
+
+/*
+ * ==============================================
+ *                    Match
+ * ==============================================
+ */
+
+int RegexSet::match(const char* s, size_t len) const {
+  int best = INT_MAX;
+
+  if (this->patterns == 0)
+    return -1;
+  if (len == 0)
+    return (this->acceptEmpty == INT_MAX) ? -1 : this->acceptEmpty;
+
+  if (this->dfa) {
+    int state = 0;
+
+    best = this->accept[state];
+    for (size_t i = 0; i < len && best != 0; ++i) {
+      state = this->table[state * this->classes + this->classOf[static_cast<unsigned char>(s[i])]];
+      if (this->accept[state] < best)
+        best = this->accept[state];
+    }
+    if (this->acceptEnd[state] < best)
+      best = this->acceptEnd[state];
+  }
+  else {
+    std::vector<char> seen(this->nfa.size(), 0);
+    std::vector<int>  from(this->initial);
+    std::vector<int>  to;
+
+    best = std::min(lowestMatch(from), this->restartMatch);
+    for (size_t i = 0; i < len && best != 0; ++i) {
+      step(from, static_cast<unsigned char>(s[i]), to, seen);
+      from.swap(to);
+      best = std::min(best, lowestMatch(from));
+    }
+    best = std::min(best, std::min(lowestMatchAtEnd(from, false, seen), this->restartMatchEnd));
+  }
+  return (best == INT_MAX) ? -1 : best;
+}
+
+/*
+ * Follows the epsilons. ^ passes only at begin; $ waits in the set until
+ * end, so the set keeps SET, MATCH and pending AT_END states, sorted.
+ */
+void RegexSet::closure(std::vector<int>& set, bool begin, bool end, std::vector<char>& seen) const {
+  std::vector<int> stack;
+  std::vector<int> visited;
+
+  stack.swap(set);
+  while (!stack.empty()) {
+    int s = stack.back();
+    stack.pop_back();
+    if (s == -1 || seen[s])
+      continue;
+    seen[s] = 1;
+    visited.push_back(s);
+
+    const State& state = this->nfa[s];
+    if (state.kind == EPSILON) {
+      stack.push_back(state.out);
+      stack.push_back(state.out1);
+    }
+    else if (state.kind == AT_BEGIN) {
+      if (begin)
+        stack.push_back(state.out);
+    }
+    else if (state.kind == AT_END && end)
+      stack.push_back(state.out);
+    else
+      set.push_back(s);
+  }
+  for (size_t i = 0; i < visited.size(); ++i)
+    seen[visited[i]] = 0;
+  std::sort(set.begin(), set.end());
+}
+
+void RegexSet::move(const std::vector<int>& from, int symbol, std::vector<int>& to, std::vector<char>& seen) const {
+  to.clear();
+  for (size_t i = 0; i < from.size(); ++i) {
+    const State& state = this->nfa[from[i]];
+    if (state.kind == SET && state.on.test(symbol))
+      to.push_back(state.out);
+  }
+  closure(to, false, false, seen);
+}
+
+/*
+ * Every pattern starts again at each byte, so the restart states belong
+ * to every set. A set holds only what is beyond them, their own step is
+ * precomputed per class.
+ */
+void RegexSet::step(const std::vector<int>& from, int symbol, std::vector<int>& to, std::vector<char>& seen) const {
+  std::vector<int> moved;
+  std::vector<int> joined;
+
+  move(from, symbol, moved, seen);
+  const std::vector<int>& again = this->restartStep[this->classOf[symbol]];
+  std::set_union(moved.begin(), moved.end(), again.begin(), again.end(), std::back_inserter(joined));
+  to.clear();
+  std::set_difference(joined.begin(), joined.end(), this->restart.begin(), this->restart.end(), std::back_inserter(to));
+}
+
+int RegexSet::lowestMatch(const std::vector<int>& set) const {
+  int lowest = INT_MAX;
+
+  for (size_t i = 0; i < set.size(); ++i)
+    if (this->nfa[set[i]].kind == MATCH && this->nfa[set[i]].pattern < lowest)
+      lowest = this->nfa[set[i]].pattern;
+  return lowest;
+}
+
+int RegexSet::lowestMatchAtEnd(const std::vector<int>& set, bool begin, std::vector<char>& seen) const {
+  std::vector<int> last(set);
+
+  closure(last, begin, true, seen);
+  return lowestMatch(last);
+}
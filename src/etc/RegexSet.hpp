@@ -0,0 +1,121 @@
+#ifndef REGEX_SET_HPP
+# define REGEX_SET_HPP
+
+# include <algorithm>
+# include <bitset>
+# include <cctype>
+# include <climits>
+# include <cstdlib>
+# include <cstring>
+# include <iterator>
+# include <map>
+# include <set>
+# include <stdexcept>
+# include <string>
+# include <utility>
+# include <vector>
+
+/*
+ * Many patterns compiled into one automaton. match() scans the subject
+ * once and answers the first pattern, in the order they were added,
+ * that matches anywhere in it. The patterns become a single Thompson
+ * NFA, turned into a DFA over byte classes by compile(); a pattern set
+ * whose DFA would grow past MAX_DFA_STATES is run as the NFA instead,
+ * still in one pass. Nothing changes after compile(), so one set can be
+ * shared by every thread.
+ *
+ * Syntax: literals, ., [...] and [^...] with ranges, \d \w \s and their
+ * negations, groups (...) and (?:...), |, * + ? {m} {m,} {m,n}, ^ and $.
+ */
+class RegexSet {
+  public:
+    RegexSet();
+    RegexSet(const RegexSet& obj);
+    ~RegexSet();
+    RegexSet&                   operator=(const RegexSet& obj);
+
+    // Throws std::runtime_error naming the pattern on a syntax error
+    void                        add(const std::string& pattern, bool caseless);
+    void                        compile();
+    // Index of the matching pattern, -1 without any
+    int                         match(const char* s, size_t len) const;
+    size_t                      size() const;
+
+    // pattern matching literal as is
+    static std::string          escape(const std::string& literal);
+
+  private:
+    static const int            SYMBOLS = 256;
+    static const size_t         MAX_DFA_STATES;
+    static const int            MAX_REPEAT;
+
+    // AT_BEGIN and AT_END are ^ and $, epsilons passable only at the ends of the subject
+    enum Kind { SET, EPSILON, AT_BEGIN, AT_END, MATCH };
+
+    struct State {
+      Kind                      kind;
+      std::bitset<SYMBOLS>      on;
+      int                       out;
+      int                       out1;
+      int                       pattern;
+    };
+
+    // A piece of NFA, its dangling exits are (state, 0 for out / 1 for out1)
+    struct Fragment {
+      int                       start;
+      std::vector<std::pair<int, int> > outs;
+    };
+
+    std::vector<State>          nfa;
+    std::vector<int>            starts;
+    int                         patterns;
+
+    // Compiled
+    bool                        dfa;
+    int                         classes;
+    std::vector<int>            classOf;
+    // Closure of starts past the first byte, a part of every state left implicit
+    std::vector<int>            restart;
+    std::vector<std::vector<int> > restartStep;
+    int                         restartMatch;
+    int                         restartMatchEnd;
+    // Subject not started yet, less restart
+    std::vector<int>            initial;
+    std::vector<int>            table;
+    // Lowest pattern matched in each DFA state, INT_MAX for none
+    std::vector<int>            accept;
+    // The same once the subject ends in that state
+    std::vector<int>            acceptEnd;
+    int                         acceptEmpty;
+
+    // Parser cursor, only while add() runs
+    const std::string*          source;
+    size_t                      cursor;
+    bool                        caseless;
+
+    int                         newState(Kind kind, int out, int out1);
+    void                        patch(const Fragment& fragment, int target);
+    Fragment                    single(const std::bitset<SYMBOLS>& on);
+    Fragment                    anchor(Kind kind);
+    Fragment                    concat(const Fragment& a, const Fragment& b);
+    Fragment                    parseAlternation();
+    Fragment                    parseConcat();
+    Fragment                    parseRepeat();
+    Fragment                    parseAtom();
+    Fragment                    repeat(const Fragment& first, size_t begin, int min, int max);
+    void                        parseClass(std::bitset<SYMBOLS>& on);
+    void                        parseEscape(std::bitset<SYMBOLS>& on);
+    int                         parseNumber();
+    void                        fold(std::bitset<SYMBOLS>& on) const;
+    void                        throwSyntax(const std::string& desc) const;
+
+    void                        closure(std::vector<int>& set, bool begin, bool end, std::vector<char>& seen) const;
+    void                        move(const std::vector<int>& from, int symbol, std::vector<int>& to, std::vector<char>& seen) const;
+    void                        step(const std::vector<int>& from, int symbol, std::vector<int>& to, std::vector<char>& seen) const;
+    int                         lowestMatch(const std::vector<int>& set) const;
+    int                         lowestMatchAtEnd(const std::vector<int>& set, bool begin, std::vector<char>& seen) const;
+    void                        buildClasses();
+    bool                        buildDfa();
+};
+
+#endif
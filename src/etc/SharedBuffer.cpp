@@ -0,0 +1,41 @@
+#include "./SharedBuffer.hpp"
+
+SharedBuffer::SharedBuffer(): block(NULL) {}
+
+SharedBuffer::SharedBuffer(std::string& data): block(new Block) {
+  this->block->bytes.swap(data);
+  this->block->refs = 1;
+}
+
+SharedBuffer::SharedBuffer(const SharedBuffer& obj): block(obj.block) {
+  if (this->block != NULL)
+    ++this->block->refs;
+}
+
+SharedBuffer& SharedBuffer::operator=(const SharedBuffer& obj) {
+  if (this->block != obj.block) {
+    release();
+    this->block = obj.block;
+    if (this->block != NULL)
+      ++this->block->refs;
+  }
+  return *this;
+}
+
+SharedBuffer::~SharedBuffer() { release(); }
+
+const char* SharedBuffer::data() const {
+  return this->block == NULL ? "" : this->block->bytes.data();
+}
+
+size_t SharedBuffer::length() const {
+  return this->block == NULL ? 0 : this->block->bytes.length();
+}
+
+bool SharedBuffer::empty() const { return length() == 0; }
+
+void SharedBuffer::release() {
+  if (this->block != NULL && --this->block->refs == 0)
+    delete this->block;
+  this->block = NULL;
+}
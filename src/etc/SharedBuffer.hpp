@@ -0,0 +1,35 @@
+#ifndef SHARED_BUFFER_HPP
+# define SHARED_BUFFER_HPP
+
+# include <string>
+
+/*
+ * Reference counted, immutable bytes. Copies share one block, which is
+ * freed with the last of them. The count is not atomic, a buffer must
+ * stay within one event loop.
+ */
+class SharedBuffer {
+  public:
+    SharedBuffer();
+    // Takes the content of data, which is left empty
+    explicit SharedBuffer(std::string& data);
+    SharedBuffer(const SharedBuffer& obj);
+    SharedBuffer&         operator=(const SharedBuffer& obj);
+    ~SharedBuffer();
+
+    const char*           data() const;
+    size_t                length() const;
+    bool                  empty() const;
+
+  private:
+    struct Block {
+      std::string         bytes;
+      unsigned            refs;
+    };
+
+    Block*                block;
+
+    void                  release();
+};
+
+#endif
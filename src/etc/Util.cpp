@@ -91,6 +91,43 @@ namespace util {
     return ss.str();
   }
 
+  std::string ltoa(long long n) {
+    std::stringstream ss;
+
+    ss << n;
+
+    return ss.str();
+  }
+
+  std::string toHex(size_t n) {
+    std::stringstream ss;
+
+    ss << std::hex << n;
+
+    return ss.str();
+  }
+
+  std::string toHttpDate(time_t t) {
+    tm   gmt;
+    char buf[64];
+
+    gmtime_r(&t, &gmt);
+    strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+    return buf;
+  }
+
+  bool parseHttpDate(const std::string& s, time_t& t) {
+    tm          gmt;
+    const char* end;
+
+    memset(&gmt, 0, sizeof(gmt));
+    end = strptime(s.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+    if (end == NULL || *end != '\0')
+      return false;
+    t = timegm(&gmt);
+    return true;
+  }
+
   int atoi(std::string s) {
     int ret = std::atoi(s.c_str());
 
@@ -201,6 +238,29 @@ namespace util {
     return fd;
   }
 
+  // Hidden temporary next to file, so it can be renamed over it
+  int openTempToWrite(const std::string& file, std::string& temp) {
+    size_t slash = file.rfind('/');
+
+    if (slash == std::string::npos)
+      temp = "." + file + ".XXXXXX";
+    else
+      temp = file.substr(0, slash + 1) + "." + file.substr(slash + 1) + ".XXXXXX";
+
+    std::vector<char> name(temp.begin(), temp.end());
+    name.push_back('\0');
+    int fd = mkstemp(&name[0]);
+    if (fd == -1)
+      throw util::SystemFunctionException();
+    if (fchmod(fd, 0644) == -1) {
+      close(fd);
+      unlink(&name[0]);
+      throw util::SystemFunctionException();
+    }
+    temp = &name[0];
+    return fd;
+  }
+
   std::string trimChar(std::string s, char c) {
     size_t f, r;
 
@@ -2,6 +2,7 @@
 # define UTIL_HPP
 
 # include <cstdlib>
+# include <cstring>
 # include <fstream>
 # include <sstream>
 # include <vector>
@@ -9,6 +10,8 @@
 # include <iostream>
 # include <unistd.h>
 # include <fcntl.h>
+# include <ctime>
+# include <sys/stat.h>
 
 const std::string CRLF = "\r\n";
 
@@ -21,13 +24,18 @@ namespace util {
   std::string toLowerStr(const std::string& s);
   std::string toUpperStr(const std::string& s);
   std::string itoa(int n);
+  std::string ltoa(long long n);
+  std::string toHex(size_t n);
+  // IMF-fixdate, "Sun, 06 Nov 1994 08:49:37 GMT"
+  std::string toHttpDate(time_t t);
+  bool parseHttpDate(const std::string& s, time_t& t);
   int atoi(std::string s);
-  const std::string getMimeType(const std::string& filename);
   void writeFile(const std::string& filename, const std::string& data);
   std::string readFd(int fd);
   void ftFree(char** data);
   int  openToRead(const std::string& file);
   int  openToWrite(const std::string& file);
+  int  openTempToWrite(const std::string& file, std::string& temp);
 
   std::pair<std::string, std::string> splitHeaderBody(const std::string& str, const std::string& delim);
   std::map<std::string, std::string> parseCGIHeader(const std::string& str);
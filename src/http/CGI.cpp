@@ -102,6 +102,10 @@ const std::string CGI::getBody(void) const {
   return this->body;
 }
 
+std::string CGI::getBodyLeft() const {
+  return this->body.substr(this->body_offset);
+}
+
 /*
  * -------------------------- Setter -------------------------------
  */
@@ -110,6 +114,10 @@ void CGI::addBodyOffset(size_t s) {
   this->body_offset += s;
 }
 
+void CGI::addCgiResult(const char* data, size_t length) {
+  this->cgi_result.append(data, length);
+}
+
 /*
  * ----------------------- Member Function -------------------------
  */
@@ -148,9 +156,28 @@ void CGI::initCGI(const HttpRequest& req, const bool sessionAvailable) {
 }
 
 void CGI::forkCGI() {
-  int     read_pipe[2];
+  int         read_pipe[2];
+  char**      argv;
+  char**      env;
+  std::string target;
+
+  // Built before fork, the child of a threaded server may only exec
+  argv = this->getArgv();
+  if (argv == NULL) {
+    withdrawResource();
+    throw INTERNAL_SERVER_ERROR;
+  }
+  env = this->envMapToEnv(this->env_map);
+  if (env == NULL) {
+    util::ftFree(argv);
+    withdrawResource();
+    throw INTERNAL_SERVER_ERROR;
+  }
+  target = getScriptPath().substr(0, getScriptPath().rfind("/"));
 
   if (pipe(read_pipe) == -1) {
+    util::ftFree(argv);
+    util::ftFree(env);
     withdrawResource();
     throw INTERNAL_SERVER_ERROR;
   }
@@ -161,6 +188,9 @@ void CGI::forkCGI() {
 
   this->pid = fork();
   if (this->pid == -1) {
+    util::ftFree(argv);
+    util::ftFree(env);
+    close(read_pipe[WRITE]);
     withdrawResource();
     throw INTERNAL_SERVER_ERROR;
   }
@@ -168,28 +198,16 @@ void CGI::forkCGI() {
     this->resource_flag |= this->f_fork;
 
   if (this->pid == 0) {
-    char**      argv;
-    char**      env;
-    std::string target;
-
-    argv = this->getArgv();
-    if (argv == NULL)
-      exit(EXIT_FAILURE);
-    env = this->envMapToEnv(this->env_map);
-    if (env == NULL) {
-      util::ftFree(argv);
-      exit(EXIT_FAILURE);
-    }
-    target = getScriptPath().substr(0, getScriptPath().rfind("/"));
-
     if (close(read_pipe[READ]) == -1 ||
         dup2(read_pipe[WRITE], STDOUT_FILENO) == -1 ||
         dup2(this->write_fd, STDIN_FILENO) == -1 ||
         chdir(target.c_str()) == -1 ||
         execve(this->cgiPath.c_str(), argv, env) == -1)
-      exit(EXIT_FAILURE);
+      _exit(EXIT_FAILURE);
   }
 
+  util::ftFree(argv);
+  util::ftFree(env);
   if (close(read_pipe[WRITE]) == -1 || fcntl(this->read_fd, F_SETFL, O_NONBLOCK) == -1) {
     withdrawResource();
     throw INTERNAL_SERVER_ERROR;
@@ -200,10 +218,10 @@ int CGI::writeCGI() {
   std::string body;
   int         write_size;
 
-  body = getBody().substr(this->body_offset);
+  body = getBodyLeft();
   write_size = write(this->write_fd, body.c_str(), body.length());
   if (write_size > 0)
-    this->body_offset += write_size;
+    addBodyOffset(write_size);
 
   return write_size;
 }
@@ -213,9 +231,8 @@ int CGI::readCGI() {
   int   read_size;
 
   read_size = read(this->read_fd, buf, READ_BUF_SIZE);
-  buf[read_size] = 0;
   if (read_size > 0)
-    this->cgi_result += std::string(buf, read_size);
+    addCgiResult(buf, read_size);
 
   return read_size;
 }
@@ -28,6 +28,11 @@ class CGI {
     int           readCGI();
     void          withdrawResource();
 
+    // For a loop doing the I/O itself: what is left to write, what was read
+    std::string   getBodyLeft() const;
+    void          addBodyOffset(size_t s);
+    void          addCgiResult(const char* data, size_t length);
+
     int           getReadFD() const;
     int           getWriteFD() const;
     int           getPid() const;
@@ -64,8 +69,6 @@ class CGI {
     const std::string                         getPathInfo(void) const;
     const std::string                         getBody(void) const;
 
-    void                                      addBodyOffset(size_t s);
-
     const std::map<std::string, std::string>  getEnvMap(const HttpRequest& req) const;
     char**                                    getArgv() const;
     char**                                    envMapToEnv(const std::map<std::string, std::string>& envMap) const;
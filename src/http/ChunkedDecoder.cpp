@@ -0,0 +1,182 @@
+#include "./ChunkedDecoder.hpp"
+#include "./HttpRequest.hpp"
+
+// Header sized, the trailer section has no share of client_max_body_size
+const size_t ChunkedDecoder::MAX_TRAILER_SIZE = 8192;
+
+ChunkedDecoder::ChunkedDecoder() {
+  reset(0);
+}
+
+ChunkedDecoder::~ChunkedDecoder() {}
+
+ChunkedDecoder::ChunkedDecoder(const ChunkedDecoder& obj) {
+  *this = obj;
+}
+
+ChunkedDecoder& ChunkedDecoder::operator=(const ChunkedDecoder& obj) {
+  if (this != &obj) {
+    this->state = obj.state;
+    this->limit = obj.limit;
+    this->total = obj.total;
+    this->remain = obj.remain;
+    this->trailerSize = obj.trailerSize;
+    this->line = obj.line;
+    this->trailers = obj.trailers;
+  }
+  return *this;
+}
+
+void ChunkedDecoder::reset(size_t limit) {
+  this->state = SIZE_START;
+  this->limit = limit;
+  this->total = 0;
+  this->remain = 0;
+  this->trailerSize = 0;
+  this->line.clear();
+  this->trailers.clear();
+}
+
+ChunkedDecoder::Result ChunkedDecoder::decode(const std::string& in, size_t& used, HttpRequest& req) {
+  const size_t  len = in.length();
+  size_t        i = 0;
+
+  while (i < len && this->state != END) {
+    char c = in[i];
+
+    switch (this->state) {
+      case SIZE_START:
+        if (hexValue(c) == -1)
+          throw BAD_REQUEST;
+        this->remain = 0;
+        this->state = SIZE;
+        // fall through
+      case SIZE:
+        if (hexValue(c) != -1) {
+          this->remain = this->remain * 16 + hexValue(c);
+          // Refused before a single byte of the chunk is read
+          if (this->remain > this->limit - this->total)
+            throw PAYLOAD_TOO_LARGE;
+        }
+        else if (c == ';' || c == ' ' || c == '\t')
+          this->state = EXTENSION;
+        else if (c == '\r')
+          this->state = SIZE_LF;
+        else if (c == '\n')
+          this->state = this->remain ? DATA : TRAILER_START;
+        else
+          throw BAD_REQUEST;
+        break;
+
+      case EXTENSION:
+        // Chunk extensions are ignored
+        if (c == '\r')
+          this->state = SIZE_LF;
+        else if (c == '\n')
+          this->state = this->remain ? DATA : TRAILER_START;
+        break;
+
+      case SIZE_LF:
+        if (c != '\n')
+          throw BAD_REQUEST;
+        this->state = this->remain ? DATA : TRAILER_START;
+        break;
+
+      case DATA: {
+        size_t n = std::min(this->remain, len - i);
+
+        req.appendBody(in.data() + i, n);
+        this->total += n;
+        this->remain -= n;
+        i += n;
+        if (this->remain == 0)
+          this->state = DATA_CR;
+        continue;
+      }
+
+      case DATA_CR:
+        if (c == '\r')
+          this->state = DATA_LF;
+        else if (c == '\n')
+          this->state = SIZE_START;
+        else
+          throw BAD_REQUEST;
+        break;
+
+      case DATA_LF:
+        if (c != '\n')
+          throw BAD_REQUEST;
+        this->state = SIZE_START;
+        break;
+
+      case TRAILER_START:
+        if (++this->trailerSize > MAX_TRAILER_SIZE)
+          throw PAYLOAD_TOO_LARGE;
+        if (c == '\r')
+          this->state = LAST_LF;
+        else if (c == '\n')
+          this->state = END;
+        else {
+          this->line = c;
+          this->state = TRAILER;
+        }
+        break;
+
+      case TRAILER:
+        if (++this->trailerSize > MAX_TRAILER_SIZE)
+          throw PAYLOAD_TOO_LARGE;
+        if (c == '\r')
+          this->state = TRAILER_LF;
+        else if (c == '\n') {
+          addTrailer();
+          this->state = TRAILER_START;
+        }
+        else
+          this->line += c;
+        break;
+
+      case TRAILER_LF:
+        if (c != '\n')
+          throw BAD_REQUEST;
+        addTrailer();
+        this->state = TRAILER_START;
+        break;
+
+      case LAST_LF:
+        if (c != '\n')
+          throw BAD_REQUEST;
+        this->state = END;
+        break;
+
+      case END:
+        break;
+    }
+    ++i;
+  }
+
+  used = i;
+  return this->state == END ? DONE : AGAIN;
+}
+
+void ChunkedDecoder::addTrailer() {
+  size_t pos = this->line.find(':');
+
+  if (pos == std::string::npos || pos == 0)
+    throw BAD_REQUEST;
+  this->trailers.push_back(std::make_pair(util::trimSpace(this->line.substr(0, pos)), util::trimSpace(this->line.substr(pos + 1))));
+  this->line.clear();
+}
+
+int ChunkedDecoder::hexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+const std::vector<std::pair<std::string, std::string> >& ChunkedDecoder::getTrailers() const {
+  return this->trailers;
+}
@@ -0,0 +1,71 @@
+#ifndef CHUNKED_DECODER_HPP
+# define CHUNKED_DECODER_HPP
+
+# include "./HttpStatus.hpp"
+
+# include <algorithm>
+# include <string>
+# include <vector>
+# include <utility>
+
+class HttpRequest;
+
+/*
+ * Streaming Transfer-Encoding: chunked decoder.
+ * decode() consumes whatever part of the body has arrived and appends the
+ * payload to the request as it goes, keeping its state between calls, so
+ * the raw and the decoded body never sit in memory together.
+ * Chunk sizes are checked against the body size limit before their data
+ * is read. Trailer fields are collected after the last chunk, up to
+ * MAX_TRAILER_SIZE bytes apart from the body limit.
+ */
+class ChunkedDecoder {
+  public:
+    enum Result {
+      AGAIN,
+      DONE
+    };
+
+    ChunkedDecoder();
+    ~ChunkedDecoder();
+    ChunkedDecoder(const ChunkedDecoder& obj);
+    ChunkedDecoder&           operator=(const ChunkedDecoder& obj);
+
+    void                      reset(size_t limit);
+
+    // Consumes from in, returns the number of bytes consumed in used
+    Result                    decode(const std::string& in, size_t& used, HttpRequest& req);
+
+    const std::vector<std::pair<std::string, std::string> >& getTrailers() const;
+
+  private:
+    static const size_t       MAX_TRAILER_SIZE;
+
+    enum State {
+      SIZE_START,
+      SIZE,
+      EXTENSION,
+      SIZE_LF,
+      DATA,
+      DATA_CR,
+      DATA_LF,
+      TRAILER_START,
+      TRAILER,
+      TRAILER_LF,
+      LAST_LF,
+      END
+    };
+
+    State                     state;
+    size_t                    limit;
+    size_t                    total;
+    size_t                    remain;
+    size_t                    trailerSize;
+    std::string               line;
+    std::vector<std::pair<std::string, std::string> > trailers;
+
+    void                      addTrailer();
+    static int                hexValue(char c);
+};
+
+#endif
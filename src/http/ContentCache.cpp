@@ -0,0 +1,126 @@
+#include "./ContentCache.hpp"
+
+ContentCache::Entry::Entry():
+  dev(0),
+  ino(0),
+  size(0),
+  mtime(0),
+  ctime(0),
+  validated(0) {}
+
+/*
+ * ==============================================
+ *                 Constructor
+ * ==============================================
+ */
+
+ContentCache::ContentCache(size_t budget, size_t max_file_size, time_t valid):
+  budget(budget),
+  max_file_size(std::min(budget, max_file_size)),
+  valid(valid),
+  used(0) {}
+
+/*
+ * ==============================================
+ *                 Destructor
+ * ==============================================
+ */
+
+ContentCache::~ContentCache() {}
+
+/*
+ * ==============================================
+ *                   Public
+ * ==============================================
+ */
+
+const ContentCache::Entry* ContentCache::find(const std::string& path) {
+  if (this->budget == 0)
+    return NULL;
+
+  EntryMap::iterator it = this->entries.find(path);
+  if (it == this->entries.end())
+    return NULL;
+
+  Entry& entry = it->second;
+  time_t now = time(NULL);
+  if (now - entry.validated >= this->valid) {
+    struct stat st;
+
+    if (stat(path.c_str(), &st) == -1 || st.st_dev != entry.dev || st.st_ino != entry.ino
+        || st.st_size != entry.size || st.st_mtime != entry.mtime || st.st_ctime != entry.ctime) {
+      evict(it);
+      return NULL;
+    }
+    entry.validated = now;
+  }
+  this->lru.splice(this->lru.begin(), this->lru, entry.lru);
+  return &entry;
+}
+
+const ContentCache::Entry* ContentCache::insert(const OpenFileCache::File& file, int fd) {
+  if (this->budget == 0 || static_cast<size_t>(file.size) > this->max_file_size)
+    return NULL;
+
+  std::string bytes(file.size, '\0');
+  size_t      got = 0;
+  while (got < bytes.length()) {
+    ssize_t n = pread(fd, &bytes[got], bytes.length() - got, got);
+    if (n <= 0)
+      return NULL;
+    got += n;
+  }
+
+  HttpResponseHeader header;
+  header.set(HttpResponseHeader::LAST_MODIFIED, file.lastModified);
+  header.set(HttpResponseHeader::ACCEPT_RANGES, "bytes");
+
+  invalidate(file.path);
+
+  Entry entry;
+  entry.path = file.path;
+  entry.head = header.toStringForResponse();
+  entry.body = SharedBuffer(bytes);
+  entry.type = file.type;
+  entry.etag = file.etag;
+  entry.lastModified = file.lastModified;
+  entry.dev = file.dev;
+  entry.ino = file.ino;
+  entry.size = file.size;
+  entry.mtime = file.mtime;
+  entry.ctime = file.ctime;
+  entry.validated = time(NULL);
+
+  while (!this->lru.empty() && this->used + cost(entry) > this->budget)
+    evict(this->entries.find(this->lru.back()));
+  if (this->used + cost(entry) > this->budget)
+    return NULL;
+
+  this->lru.push_front(entry.path);
+  entry.lru = this->lru.begin();
+  this->used += cost(entry);
+  return &(this->entries[entry.path] = entry);
+}
+
+void ContentCache::invalidate(const std::string& path) {
+  EntryMap::iterator it = this->entries.find(path);
+
+  if (it != this->entries.end())
+    evict(it);
+}
+
+/*
+ * ==============================================
+ *                   Private
+ * ==============================================
+ */
+
+size_t ContentCache::cost(const Entry& entry) const {
+  return entry.path.length() + entry.head.length() + entry.body.length();
+}
+
+void ContentCache::evict(EntryMap::iterator it) {
+  this->used -= cost(it->second);
+  this->lru.erase(it->second.lru);
+  this->entries.erase(it);
+}
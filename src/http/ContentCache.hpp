@@ -0,0 +1,72 @@
+#ifndef CONTENT_CACHE_HPP
+# define CONTENT_CACHE_HPP
+
+# include "./OpenFileCache.hpp"
+# include "./header/HttpResponseHeader.hpp"
+# include "../etc/SharedBuffer.hpp"
+# include "../etc/Util.hpp"
+
+# include <algorithm>
+# include <list>
+# include <map>
+# include <string>
+# include <time.h>
+# include <unistd.h>
+# include <sys/stat.h>
+
+/*
+ * Contents of small static files together with their type, etag and the
+ * serialized last-modified/accept-ranges lines. A hit touches neither the
+ * disk nor the types table, and the body goes out of the shared copy.
+ * Files are checked against the disk every `valid` seconds; beyond the
+ * memory budget the least recently used are dropped.
+ */
+class ContentCache {
+  public:
+    struct Entry {
+      std::string               path;
+      std::string               head;
+      SharedBuffer              body;
+      std::string               type;
+      std::string               etag;
+      std::string               lastModified;
+
+      dev_t                     dev;
+      ino_t                     ino;
+      off_t                     size;
+      time_t                    mtime;
+      time_t                    ctime;
+      time_t                    validated;
+      std::list<std::string>::iterator lru;
+
+      Entry();
+    };
+
+    // budget 0 turns the cache off
+    ContentCache(size_t budget, size_t max_file_size, time_t valid);
+    ~ContentCache();
+
+    const Entry*                find(const std::string& path);
+    // Reads file in through fd, NULL when it is too big or unreadable
+    const Entry*                insert(const OpenFileCache::File& file, int fd);
+    void                        invalidate(const std::string& path);
+
+  private:
+    typedef std::map<std::string, Entry> EntryMap;
+
+    size_t                      budget;
+    size_t                      max_file_size;
+    time_t                      valid;
+    size_t                      used;
+    EntryMap                    entries;
+    // Most recently used first
+    std::list<std::string>      lru;
+
+    size_t                      cost(const Entry& entry) const;
+    void                        evict(EntryMap::iterator it);
+
+    ContentCache(const ContentCache& obj);
+    ContentCache&               operator=(const ContentCache& obj);
+};
+
+#endif
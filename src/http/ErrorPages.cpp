@@ -0,0 +1,125 @@
+#include "./ErrorPages.hpp"
+
+const int ErrorPages::FIRST_STATUS = 400;
+const int ErrorPages::LAST_STATUS = 599;
+
+/*
+ * ==============================================
+ *                 Constructor
+ * ==============================================
+ */
+
+ErrorPages::ErrorPages(const HttpConfig& config) {
+  std::map<std::string, SharedBuffer> files;
+
+  for (int s = FIRST_STATUS; s <= LAST_STATUS; ++s) {
+    std::string page = render(static_cast<HttpStatus>(s));
+    this->defaults[s] = SharedBuffer(page);
+  }
+
+  const std::vector<ServerConfig>& servers = config.getServerConfig();
+  for (std::vector<ServerConfig>::const_iterator it = servers.begin(); it != servers.end(); ++it) {
+    const std::vector<LocationConfig>& locations = it->getCompiledLocations();
+
+    for (size_t i = 0; i < locations.size(); ++i)
+      load(locations[i], files);
+    load(it->getDefaultLocation(), files);
+  }
+}
+
+/*
+ * ==============================================
+ *                 Destructor
+ * ==============================================
+ */
+
+ErrorPages::~ErrorPages() {}
+
+/*
+ * ==============================================
+ *                   Public
+ * ==============================================
+ */
+
+const SharedBuffer& ErrorPages::find(HttpStatus status, const LocationConfig& location) {
+  if (!location.getErrorPage().empty()) {
+    std::map<Key, SharedBuffer>::const_iterator it = this->pages.find(Key(&location, status));
+    if (it != this->pages.end())
+      return it->second;
+  }
+  return findDefault(status);
+}
+
+/*
+ * ==============================================
+ *                   Private
+ * ==============================================
+ */
+
+void ErrorPages::load(const LocationConfig& location, std::map<std::string, SharedBuffer>& files) {
+  const std::map<int, std::string>& errorPage = location.getErrorPage();
+
+  for (std::map<int, std::string>::const_iterator it = errorPage.begin(); it != errorPage.end(); ++it) {
+    std::string path = location.getErrorPageTargetPath(it->first);
+    if (path.empty())
+      continue;
+
+    std::map<std::string, SharedBuffer>::iterator file = files.find(path);
+    if (file == files.end()) {
+      std::string bytes;
+      if (!readFile(path, bytes))
+        continue;
+      file = files.insert(std::make_pair(path, SharedBuffer(bytes))).first;
+    }
+    this->pages[Key(&location, it->first)] = file->second;
+  }
+}
+
+// Statuses outside the table are rendered on their first use
+const SharedBuffer& ErrorPages::findDefault(HttpStatus status) {
+  std::map<int, SharedBuffer>::iterator it = this->defaults.find(status);
+
+  if (it == this->defaults.end()) {
+    std::string page = render(status);
+    it = this->defaults.insert(std::make_pair(static_cast<int>(status), SharedBuffer(page))).first;
+  }
+  return it->second;
+}
+
+// The bytes of a regular file as they are
+bool ErrorPages::readFile(const std::string& path, std::string& bytes) {
+  struct stat st;
+  int         fd = open(path.c_str(), O_RDONLY);
+  size_t      got = 0;
+
+  if (fd == -1)
+    return false;
+  if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return false;
+  }
+  bytes.assign(st.st_size, '\0');
+  while (got < bytes.length()) {
+    ssize_t n = read(fd, &bytes[got], bytes.length() - got);
+    if (n <= 0)
+      break;
+    got += n;
+  }
+  close(fd);
+  return got == bytes.length();
+}
+
+std::string ErrorPages::render(HttpStatus s) {
+  std::string ret = "<html><head><title>"\
++ util::itoa(s) + " " + getStatusText(s)\
++ "</title></head>\
+<body>\
+<center><h1>"\
++ util::itoa(s) + " " + getStatusText(s)\
++ "</h1></center>\
+<hr><center>webserv/1.0.0</center>\
+</body>\
+</html>";
+
+  return ret;
+}
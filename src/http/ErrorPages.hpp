@@ -0,0 +1,52 @@
+#ifndef ERROR_PAGES_HPP
+# define ERROR_PAGES_HPP
+
+# include "./HttpStatus.hpp"
+# include "../config/HttpConfig.hpp"
+# include "../etc/SharedBuffer.hpp"
+# include "../etc/Util.hpp"
+
+# include <map>
+# include <string>
+# include <utility>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/stat.h>
+
+/*
+ * Every error page body a loop can send, rendered when the loop is built
+ * from the loaded config: the default page of each 4xx/5xx status, and
+ * the error_page files of every location, each file read once however
+ * many locations name it. An error response then shares one of these
+ * buffers, no file is opened and no HTML is built. A file that can't be
+ * read leaves its location with the default page, as before. The
+ * buffers are per loop, a SharedBuffer never crosses threads.
+ */
+class ErrorPages {
+  public:
+    ErrorPages(const HttpConfig& config);
+    ~ErrorPages();
+
+    // The page location answers status with
+    const SharedBuffer&         find(HttpStatus status, const LocationConfig& location);
+
+  private:
+    typedef std::pair<const LocationConfig*, int> Key;
+
+    static const int            FIRST_STATUS;
+    static const int            LAST_STATUS;
+
+    std::map<int, SharedBuffer> defaults;
+    // Only the statuses a location has an error_page for
+    std::map<Key, SharedBuffer> pages;
+
+    void                        load(const LocationConfig& location, std::map<std::string, SharedBuffer>& files);
+    const SharedBuffer&         findDefault(HttpStatus status);
+    static bool                 readFile(const std::string& path, std::string& bytes);
+    static std::string          render(HttpStatus status);
+
+    ErrorPages(const ErrorPages& obj);
+    ErrorPages&                 operator=(const ErrorPages& obj);
+};
+
+#endif
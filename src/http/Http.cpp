@@ -1,38 +1,49 @@
 #include "./Http.hpp"
 #include "HttpStatus.hpp"
 
+#include <cctype>
+#include <cstdlib>
+
+const size_t Http::MAX_RANGES = 16;
+
 Http::Http() {}
 
 Http::~Http() {}
 
-HttpResponse Http::processing(const HttpRequest& req, SessionManager& manager) {
+HttpResponse Http::processing(HttpRequest& req, SessionManager& manager, OpenFileCache& cache, ContentCache& content,
+                              NegativeCache& misses, ErrorPages& pages) {
   HttpResponse res;
 
   try {
     checkAndThrowError(req);
-    if (req.getLocationConfig().hasReturn()) {
+    if (req.isHandler(HttpRequest::RETURN_HANDLER)) {
       res.setStatusCode(static_cast<HttpStatus>(req.getLocationConfig().getReturn().first));
       res.getHeader().set(HttpResponseHeader::LOCATION, req.getLocationConfig().getReturn().second);
       return res;
     }
-    if (req.isCGI()) res = executeCGI(req, manager);
-    else if (req.isMethod(request_method::GET) || req.isMethod(request_method::HEAD))
-      res = getMethod(req);
+    if (req.isHandler(HttpRequest::CGI_HANDLER)) res = executeCGI(req, manager);
+    else if (req.isMethod(request_method::GET) || req.isMethod(request_method::HEAD)) {
+      res = getMethod(req, cache, content, misses, pages);
+      // Caches keyed on the URL alone must not hand one variant to every client
+      if (req.getLocationConfig().isGzipStatic() || req.getLocationConfig().isBrotliStatic())
+        res.getHeader().set(HttpResponseHeader::VARY, HttpRequestHeader::ACCEPT_ENCODING);
+    }
     else if (req.isMethod(request_method::POST))
-      res = postMethod(req);
+      res = postMethod(req, cache, content, misses);
     else if (req.isMethod(request_method::DELETE))
-      res = deleteMethod(req);
+      res = deleteMethod(req, cache, content);
     else if (req.isMethod(request_method::PUT))
-      res = putMethod(req);
+      res = putMethod(req, cache, content, misses);
 
-    if (res.isSetFd() && fcntl(res.getFd(), F_SETFL, O_NONBLOCK) == -1) {
+    // Cached files are opened non-blocking already
+    if (res.isSetFd() && !res.isFileBody() && fcntl(res.getFd(), F_SETFL, O_NONBLOCK) == -1) {
       logger::error << "method's file fcntl failed" << logger::endl;
       close(res.getFd());
       res.unsetFd();
       throw (INTERNAL_SERVER_ERROR);
     }
   } catch (HttpStatus status) {
-    res = getErrorPage(status, req);
+    res = getErrorPage(status, req, pages);
   }
 
   return res;
@@ -41,12 +52,34 @@ HttpResponse Http::processing(const HttpRequest& req, SessionManager& manager) {
 void Http::checkAndThrowError(const HttpRequest& req) {
   if (req.isRecvStatus(HttpRequest::RECEIVE_ERROR))
     throw (req.getErrorStatusCode());
-  if (req.getBody().size() > static_cast<size_t>(req.getLocationConfig().getClientMaxBodySize()))
+  if (req.getBodyLength() > static_cast<size_t>(req.getLocationConfig().getClientMaxBodySize()))
     throw (PAYLOAD_TOO_LARGE);
   if (req.getLocationConfig().isMethodAllowed(req.getMethod()) == false)
     throw (METHOD_NOT_ALLOWED);
 }
 
+bool Http::prepareUpload(HttpRequest& req) {
+  std::string temp;
+
+  // Anything processing() would refuse keeps the in-memory path
+  if (!req.isHandler(HttpRequest::FILE_HANDLER))
+    return false;
+  if (!req.isMethod(request_method::POST) && !req.isMethod(request_method::PUT))
+    return false;
+  if (req.getLocationConfig().isMethodAllowed(req.getMethod()) == false)
+    return false;
+  if (req.isTargetDir())
+    return false;
+
+  try {
+    int fd = util::openTempToWrite(req.getTargetPath(), temp);
+    req.setBodyFile(fd, temp);
+  } catch (util::SystemFunctionException& e) {
+    return false;
+  }
+  return true;
+}
+
 HttpResponse Http::executeCGI(const HttpRequest& req, SessionManager& sm) {
   std::string                         cgi_ret;
   HttpResponse                        res;
@@ -64,7 +97,7 @@ HttpResponse Http::executeCGI(const HttpRequest& req, SessionManager& sm) {
   return res;
 }
 
-void Http::finishCGI(HttpResponse& res, const HttpRequest& req, SessionManager& sm) {
+void Http::finishCGI(HttpResponse& res, const HttpRequest& req, SessionManager& sm, ErrorPages& pages) {
   std::string                         body;
   std::map<std::string, std::string>  header;
 
@@ -88,66 +121,363 @@ void Http::finishCGI(HttpResponse& res, const HttpRequest& req, SessionManager&
     res.getHeader().remove(CGI_STATUS);
   }
   else
-    res = Http::getErrorPage(BAD_GATEWAY, req);
+    res = Http::getErrorPage(BAD_GATEWAY, req, pages);
 }
 
-HttpResponse Http::getMethod(const HttpRequest& req) {
-  HttpResponse res;
-  struct stat _stat;
+void Http::applyGzip(const HttpRequest& req, HttpResponse& res) {
+  const LocationConfig& location = req.getLocationConfig();
+  HttpStatus            status = res.getStatusCode();
+
+  if (!location.isGzip() || req.isMethod(request_method::HEAD))
+    return;
+  // Ranges are cut from the identity bytes, and some statuses carry no body
+  if (status < OK || status == NO_CONTENT || status == PARTIAL_CONTENT || status == NOT_MODIFIED)
+    return;
+  if (!res.getHeader().get(HttpResponseHeader::CONTENT_ENCODING).empty())
+    return;
+  if (!location.isGzipType(res.getHeader().get(HttpResponseHeader::CONTENT_TYPE)))
+    return;
+  if (res.getBodyLength() < location.getGzipMinLength())
+    return;
+
+  res.getHeader().set(HttpResponseHeader::VARY, HttpRequestHeader::ACCEPT_ENCODING);
+  if (getAcceptQuality(req.getHeader().get(HttpRequestHeader::ACCEPT_ENCODING), "gzip") <= 0)
+    return;
+  // A file is deflated as it is sent and goes out chunked, which HTTP/1.0 lacks
+  if (res.isFileBody() && req.getVersion() != "HTTP/1.1")
+    return;
+  res.setGzip(location.getGzipCompLevel());
+}
+
+HttpResponse Http::getMethod(const HttpRequest& req, OpenFileCache& cache, ContentCache& content, NegativeCache& misses,
+                             ErrorPages& pages) {
+  HttpResponse               res;
+  const ContentCache::Entry* entry;
+  const NegativeCache::Entry* miss;
+  // The cached header carries the file's own content type
+  bool                       cacheable = req.getHeader().get(HttpRequestHeader::CONTENT_TYPE).empty();
 
-  if (stat(req.getTargetPath().c_str(), &_stat) == -1)
+  // Ranges are cut from the file, the cached head describes it whole
+  if (!req.getHeader().get(HttpRequestHeader::RANGE).empty())
+    cacheable = false;
+
+  std::string                path = req.getTargetPath();
+
+  // A known miss goes out before anything touches the disk
+  if (isMissCacheable(req, misses) && (miss = misses.find(path, req.getLocationConfig())) != NULL)
+    return getCachedMiss(*miss);
+
+  std::string                encoding;
+  const OpenFileCache::File* file = findPrecompressed(req, path, cache, encoding);
+
+  if (file == NULL && cacheable && (entry = content.find(path)) != NULL)
+    return getCachedContent(req, *entry);
+  if (file == NULL && (file = cache.find(path)) == NULL) {
+    if (isMissCacheable(req, misses))
+      return getMissing(req, misses, pages);
     throw NOT_FOUND;
+  }
 
-  if (S_ISDIR(_stat.st_mode)) {
+  if (S_ISDIR(file->mode)) {
     if (req.getLocationConfig().isAutoindex()) {
       res.setStatusCode(OK);
       res.getHeader().set(HttpResponseHeader::CONTENT_TYPE, "text/html");
       res.setBody(generateAutoindex(req));
+      return res;
     }
     else if (req.getLocationConfig().getIndex() != "") {
-      try {
-        int fd = util::openToRead(req.getTargetPath() + req.getLocationConfig().getIndex());
-        res.setFd(fd);
-      } catch(util::SystemFunctionException& e) {
+      path = req.getResolvedPath();
+      file = findPrecompressed(req, path, cache, encoding);
+      if (file == NULL && cacheable && (entry = content.find(path)) != NULL)
+        return getCachedContent(req, *entry);
+      if (file == NULL)
+        file = cache.find(path);
+      if (file == NULL || !S_ISREG(file->mode))
         throw (NOT_FOUND);
-      }
     }
     else
       throw (NOT_FOUND);
   }
-  else if (S_ISREG(_stat.st_mode)) {
-    try {
-      int fd = util::openToRead(req.getTargetPath());
-      res.setFd(fd);
-    } catch(util::SystemFunctionException& e) {
-      throw (NOT_FOUND);
-    }
-  }
-  else
+  else if (!S_ISREG(file->mode))
     throw (FORBIDDEN);
 
+  // Answered from the stat data, the file is not opened
+  if (isNotModified(req, file->etag, file->mtime))
+    return getNotModified(file->etag, file->lastModified);
+
   res.setStatusCode(OK);
-  res.getHeader().set(HttpResponseHeader::CONTENT_TYPE, req.getContentType());
+  std::string type = req.getHeader().get(HttpRequestHeader::CONTENT_TYPE);
+  if (type.empty())
+    type = encoding.empty() ? file->type : cache.getType(path);
+  res.getHeader().set(HttpResponseHeader::CONTENT_TYPE, type);
+  if (!encoding.empty())
+    res.getHeader().set(HttpResponseHeader::CONTENT_ENCODING, encoding);
+  res.getHeader().set(HttpResponseHeader::ETAG, file->etag);
+  res.getHeader().set(HttpResponseHeader::LAST_MODIFIED, file->lastModified);
+  res.getHeader().set(HttpResponseHeader::ACCEPT_RANGES, "bytes");
+  res.setFileBody(file->size);
+  if (req.isMethod(request_method::HEAD)) {
+    res.omitBody();
+    return res;
+  }
+
+  // A stale If-Range or a malformed Range gets the whole file
+  std::vector<std::pair<off_t, off_t> > ranges;
+  std::string range = req.getHeader().get(HttpRequestHeader::RANGE);
+  bool ranged = !range.empty() && isRangeFresh(req, file->etag, file->mtime)
+                && parseRange(range, file->size, ranges);
+  if (ranged && ranges.empty()) {
+    res = getErrorPage(RANGE_NOT_SATISFIABLE, req, pages);
+    res.getHeader().set(HttpResponseHeader::CONTENT_RANGE, "bytes */" + util::ltoa(file->size));
+    return res;
+  }
+
+  int fd = cache.take(file);
+  if (fd == -1)
+    throw (NOT_FOUND);
+  if (ranged) {
+    res.setStatusCode(PARTIAL_CONTENT);
+    res.setFileRanges(ranges);
+  }
+  else if (cacheable && encoding.empty() && (entry = content.insert(*file, fd)) != NULL) {
+    close(fd);
+    return getCachedContent(req, *entry);
+  }
+  res.setFd(fd);
 
   return res;
 }
 
-HttpResponse Http::postMethod(const HttpRequest& req) {
+HttpResponse Http::getCachedContent(const HttpRequest& req, const ContentCache::Entry& entry) {
   HttpResponse res;
-  struct stat _stat;
 
-  if (stat(req.getTargetPath().c_str(), &_stat) == 0) {
-    if (S_ISDIR(_stat.st_mode))
-      throw (FORBIDDEN);
+  if (isNotModified(req, entry.etag, entry.mtime))
+    return getNotModified(entry.etag, entry.lastModified);
+  res.setStatusCode(OK);
+  // Kept out of the cached head, gzip may still change them
+  res.getHeader().set(HttpResponseHeader::CONTENT_TYPE, entry.type);
+  res.getHeader().set(HttpResponseHeader::ETAG, entry.etag);
+  res.setCachedBody(entry.head, entry.body);
+  if (req.isMethod(request_method::HEAD))
+    res.omitBody();
+  return res;
+}
+
+/*
+ * Only a target that was not there at all, in a location without
+ * gzip_static or brotli_static: there a sidecar may still answer for a
+ * missing file, depending on the client.
+ */
+bool Http::isMissCacheable(const HttpRequest& req, const NegativeCache& misses) {
+  const LocationConfig& location = req.getLocationConfig();
+
+  return misses.isEnabled() && !req.isTargetFound() && !location.isGzipStatic() && !location.isBrotliStatic();
+}
+
+HttpResponse Http::getMissing(const HttpRequest& req, NegativeCache& misses, ErrorPages& pages) {
+  const LocationConfig&       location = req.getLocationConfig();
+  const NegativeCache::Entry* miss = misses.insert(req.getTargetPath(), location, pages.find(NOT_FOUND, location),
+                                                    req.getStatWrites());
+
+  if (miss == NULL)
+    throw NOT_FOUND;
+  return getCachedMiss(*miss);
+}
+
+HttpResponse Http::getCachedMiss(const NegativeCache::Entry& entry) {
+  HttpResponse res;
+
+  res.setError(true);
+  res.setStatusCode(NOT_FOUND);
+  res.getHeader().set(HttpResponseHeader::CONTENT_TYPE, "text/html");
+  res.setCachedBody("", entry.body);
+  return res;
+}
+
+// If-None-Match wins over If-Modified-Since, compared weakly as for GET
+bool Http::isNotModified(const HttpRequest& req, const std::string& etag, time_t mtime) {
+  std::string match = req.getHeader().get(HttpRequestHeader::IF_NONE_MATCH);
+
+  if (!match.empty()) {
+    std::vector<std::string> tags = util::split(match, ',');
+    for (size_t i = 0; i < tags.size(); ++i) {
+      std::string tag = util::trimSpace(tags[i]);
+      if (tag.compare(0, 2, "W/") == 0)
+        tag = tag.substr(2);
+      if (tag == "*" || tag == etag)
+        return true;
+    }
+    return false;
   }
 
-  try {
+  std::string since = req.getHeader().get(HttpRequestHeader::IF_MODIFIED_SINCE);
+  time_t      t;
+  return !since.empty() && util::parseHttpDate(since, t) && mtime <= t;
+}
+
+HttpResponse Http::getNotModified(const std::string& etag, const std::string& lastModified) {
+  HttpResponse res;
+
+  res.setStatusCode(NOT_MODIFIED);
+  res.getHeader().set(HttpResponseHeader::ETAG, etag);
+  res.getHeader().set(HttpResponseHeader::LAST_MODIFIED, lastModified);
+  return res;
+}
+
+// path.br or path.gz, whichever the client weighs higher, when the location has it on.
+// The sidecars are looked up through the stat cache like any other file.
+const OpenFileCache::File* Http::findPrecompressed(const HttpRequest& req, const std::string& path,
+                                                   OpenFileCache& cache, std::string& encoding) {
+  const LocationConfig& location = req.getLocationConfig();
+  std::string           accept = req.getHeader().get(HttpRequestHeader::ACCEPT_ENCODING);
+
+  if (accept.empty() || path.empty() || path[path.length() - 1] == '/')
+    return NULL;
+  if (!location.isGzipStatic() && !location.isBrotliStatic())
+    return NULL;
+
+  std::string codings[2] = { "br", "gzip" };
+  std::string suffixes[2] = { ".br", ".gz" };
+  float       quality[2];
+  quality[0] = location.isBrotliStatic() ? getAcceptQuality(accept, codings[0]) : 0;
+  quality[1] = location.isGzipStatic() ? getAcceptQuality(accept, codings[1]) : 0;
+  // br goes first on a tie, it is the smaller of the two
+  int first = quality[1] > quality[0] ? 1 : 0;
+
+  for (int i = 0; i < 2; ++i) {
+    int c = (first + i) % 2;
+    if (quality[c] <= 0)
+      continue;
+    const OpenFileCache::File* file = cache.find(path + suffixes[c]);
+    if (file != NULL && S_ISREG(file->mode)) {
+      encoding = codings[c];
+      return file;
+    }
+  }
+  return NULL;
+}
+
+// The q-value of coding in Accept-Encoding, 0 when it is refused or not listed
+float Http::getAcceptQuality(const std::string& accept, const std::string& coding) {
+  std::vector<std::string> items = util::split(accept, ',');
+  float                    any = 0;
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    std::vector<std::string> params = util::split(items[i], ';');
+    if (params.empty())
+      continue;
+
+    std::string name = util::toLowerStr(util::trimSpace(params[0]));
+    float       q = 1;
+    for (size_t j = 1; j < params.size(); ++j) {
+      std::string param = util::trimSpace(params[j]);
+      if (param.compare(0, 2, "q=") == 0 || param.compare(0, 2, "Q=") == 0)
+        q = std::strtod(param.c_str() + 2, NULL);
+    }
+
+    if (name == coding || (coding == "gzip" && name == "x-gzip"))
+      return q;
+    if (name == "*")
+      any = q;
+  }
+  return any;
+}
+
+// If-Range takes a strong etag or the exact Last-Modified date
+bool Http::isRangeFresh(const HttpRequest& req, const std::string& etag, time_t mtime) {
+  std::string cond = req.getHeader().get(HttpRequestHeader::IF_RANGE);
+  time_t      t;
+
+  if (cond.empty())
+    return true;
+  if (cond[0] == '"')
+    return cond == etag;
+  if (cond.compare(0, 2, "W/") == 0)
+    return false;
+  return util::parseHttpDate(cond, t) && t == mtime;
+}
+
+// bytes=first-last, first- and -suffix specs, separated by commas.
+// Returns false when the header is to be ignored, an empty ranges means nothing is satisfiable.
+bool Http::parseRange(const std::string& value, off_t size, std::vector<std::pair<off_t, off_t> >& ranges) {
+  const std::string UNIT = "bytes=";
+
+  if (value.compare(0, UNIT.length(), UNIT) != 0)
+    return false;
+
+  std::vector<std::string> specs = util::split(value.substr(UNIT.length()), ',');
+  for (size_t i = 0; i < specs.size(); ++i) {
+    std::string spec = util::trimSpace(specs[i]);
+    if (spec.empty())
+      continue;
+
+    size_t dash = spec.find('-');
+    if (dash == std::string::npos)
+      return false;
+
+    off_t first;
+    off_t last;
+    if (dash == 0) {
+      if (!parseOffset(spec.substr(1), last))
+        return false;
+      if (last == 0 || size == 0)
+        continue;
+      first = last < size ? size - last : 0;
+      last = size - 1;
+    }
+    else {
+      if (!parseOffset(spec.substr(0, dash), first))
+        return false;
+      if (dash + 1 == spec.length())
+        last = size - 1;
+      else if (!parseOffset(spec.substr(dash + 1), last) || last < first)
+        return false;
+      if (first >= size)
+        continue;
+      if (last >= size)
+        last = size - 1;
+    }
+
+    if (ranges.size() == MAX_RANGES)
+      return false;
+    ranges.push_back(std::make_pair(first, last));
+  }
+  return true;
+}
+
+bool Http::parseOffset(const std::string& digits, off_t& offset) {
+  // Also keeps the value well inside off_t
+  if (digits.empty() || digits.length() > 18)
+    return false;
+
+  offset = 0;
+  for (size_t i = 0; i < digits.length(); ++i) {
+    if (!std::isdigit(digits[i]))
+      return false;
+    offset = offset * 10 + (digits[i] - '0');
+  }
+  return true;
+}
+
+HttpResponse Http::postMethod(HttpRequest& req, OpenFileCache& cache, ContentCache& content, NegativeCache& misses) {
+  HttpResponse res;
+
+  if (req.isTargetDir())
+    throw (FORBIDDEN);
+
+  cache.invalidate(req.getTargetPath());
+  content.invalidate(req.getTargetPath());
+  if (req.isBodyInFile())
+    req.commitBodyFile(req.getTargetPath());
+  else try {
     int fd = util::openToWrite(req.getTargetPath());
     res.setFd(fd);
     res.setFileBuffer(req.getBody());
   } catch (util::SystemFunctionException& e) {
     throw (FORBIDDEN);
   }
+  // Once the file exists, every loop's misses are checked again
+  misses.invalidate(req.getTargetPath());
 
   res.setStatusCode(CREATED);
   res.getHeader().set(HttpResponseHeader::CONTENT_TYPE, req.getContentType());
@@ -160,69 +490,55 @@ HttpResponse Http::postMethod(const HttpRequest& req) {
   return res;
 }
 
-HttpResponse Http::deleteMethod(const HttpRequest& req) {
+HttpResponse Http::deleteMethod(const HttpRequest& req, OpenFileCache& cache, ContentCache& content) {
   HttpResponse res;
-  struct stat _stat;
 
-  if (stat(req.getTargetPath().c_str(), &_stat) == 0) {
-    if (S_ISDIR(_stat.st_mode))
-      throw (FORBIDDEN);
-  }
-  else
+  if (!req.isTargetFound())
     throw (NOT_FOUND);
+  if (req.isTargetDir())
+    throw (FORBIDDEN);
 
+  cache.invalidate(req.getTargetPath());
+  content.invalidate(req.getTargetPath());
+  // The stat is from the header, another request may have removed it since
   if (std::remove(req.getTargetPath().c_str()) == -1)
-    throw (INTERNAL_SERVER_ERROR);
+    throw (errno == ENOENT ? NOT_FOUND : INTERNAL_SERVER_ERROR);
 
   res.setStatusCode(OK);
 
   return res;
 }
 
-HttpResponse Http::putMethod(const HttpRequest& req) {
+HttpResponse Http::putMethod(HttpRequest& req, OpenFileCache& cache, ContentCache& content, NegativeCache& misses) {
   HttpResponse res;
-  struct stat _stat;
 
-  if (stat(req.getTargetPath().c_str(), &_stat) == 0) {
-    if (S_ISDIR(_stat.st_mode))
-      throw (FORBIDDEN);
-  }
+  if (req.isTargetDir())
+    throw (FORBIDDEN);
 
-  try {
+  cache.invalidate(req.getTargetPath());
+  content.invalidate(req.getTargetPath());
+  if (req.isBodyInFile())
+    req.commitBodyFile(req.getTargetPath());
+  else try {
     int fd = util::openToWrite(req.getTargetPath());
     res.setFd(fd);
     res.setFileBuffer(req.getBody());
   } catch(util::SystemFunctionException& e) {
     throw (FORBIDDEN);
   }
+  // Once the file exists, every loop's misses are checked again
+  misses.invalidate(req.getTargetPath());
 
   res.setStatusCode(NO_CONTENT);
 
   return res;
 }
 
-HttpResponse Http::getErrorPage(HttpStatus status, const HttpRequest& req) {
-  HttpResponse          res = HttpResponse();
-  std::string           data;
-  const LocationConfig& config = req.getLocationConfig();
-
-  std::string errorPagePath = config.getErrorPageTargetPath(status);
-  if (errorPagePath.empty())
-    res.setBody(generateDefaultErrorPage(status));
-  else {
-    try {
-      int fd = util::openToRead(errorPagePath);
-      res.setFd(fd);
-      if (fcntl(fd, F_SETFL, O_NONBLOCK) == -1) {
-        logger::error << "error page file's fcntl failed" << logger::endl;
-        close(fd);
-        throw (util::SystemFunctionException());
-      }
-    } catch (util::SystemFunctionException& e) {
-      res.unsetFd();
-      res.setBody(generateDefaultErrorPage(status));
-    }
-  }
+// The page comes prerendered, an error costs neither file I/O nor HTML building
+HttpResponse Http::getErrorPage(HttpStatus status, const HttpRequest& req, ErrorPages& pages) {
+  HttpResponse res;
+
+  res.setCachedBody("", pages.find(status, req.getLocationConfig()));
   res.setError(true);
   res.setStatusCode(status);
   res.getHeader().set(HttpResponseHeader::CONTENT_TYPE, "text/html");
@@ -230,21 +546,6 @@ HttpResponse Http::getErrorPage(HttpStatus status, const HttpRequest& req) {
   return res;
 }
 
-std::string Http::generateDefaultErrorPage(HttpStatus s) {
-  std::string ret = "<html><head><title>"\
-+ util::itoa(s) + " " + getStatusText(s)\
-+ "</title></head>\
-<body>\
-<center><h1>"\
-+ util::itoa(s) + " " + getStatusText(s)\
-+ "</h1></center>\
-<hr><center>webserv/1.0.0</center>\
-</body>\
-</html>";
-
-  return ret;
-}
-
 std::string Http::generateAutoindex(const HttpRequest& req) {
   std::string     ret;
   DIR*            dir;
@@ -6,6 +6,10 @@
 # include "./HttpRequest.hpp"
 # include "./HttpResponse.hpp"
 # include "./CGI.hpp"
+# include "./ContentCache.hpp"
+# include "./ErrorPages.hpp"
+# include "./NegativeCache.hpp"
+# include "./OpenFileCache.hpp"
 # include "../config/ServerConfig.hpp"
 # include "../etc/Logger.hpp"
 # include "../network/SessionManager.hpp"
@@ -19,19 +23,39 @@ class Http {
     Http();
     ~Http();
 
-    static HttpResponse processing(const HttpRequest& req, SessionManager& manager);
-    static HttpResponse getErrorPage(HttpStatus s, const HttpRequest& req);
-    static void         finishCGI(HttpResponse& res, const HttpRequest& req, SessionManager& sm);
+    static HttpResponse processing(HttpRequest& req, SessionManager& manager, OpenFileCache& cache, ContentCache& content,
+                                   NegativeCache& misses, ErrorPages& pages);
+    // Sets a file as the body sink of an upload that will be accepted
+    static bool         prepareUpload(HttpRequest& req);
+    static HttpResponse getErrorPage(HttpStatus s, const HttpRequest& req, ErrorPages& pages);
+    static void         finishCGI(HttpResponse& res, const HttpRequest& req, SessionManager& sm, ErrorPages& pages);
+    // Response filter, has res gzip encoded when the location, the client and the content allow it
+    static void         applyGzip(const HttpRequest& req, HttpResponse& res);
 
   private:
+    // More ranges than this in one request are answered with the whole file
+    static const size_t MAX_RANGES;
+
     static void         checkAndThrowError(const HttpRequest& req);
     static HttpResponse executeCGI(const HttpRequest& req, SessionManager& sm);
-    static HttpResponse getMethod(const HttpRequest& req);
-    static HttpResponse postMethod(const HttpRequest& req);
-    static HttpResponse deleteMethod(const HttpRequest& req);
-    static HttpResponse putMethod(const HttpRequest& req);
+    static HttpResponse getMethod(const HttpRequest& req, OpenFileCache& cache, ContentCache& content, NegativeCache& misses,
+                                  ErrorPages& pages);
+    static HttpResponse postMethod(HttpRequest& req, OpenFileCache& cache, ContentCache& content, NegativeCache& misses);
+    static HttpResponse deleteMethod(const HttpRequest& req, OpenFileCache& cache, ContentCache& content);
+    static HttpResponse putMethod(HttpRequest& req, OpenFileCache& cache, ContentCache& content, NegativeCache& misses);
+    static HttpResponse getCachedContent(const HttpRequest& req, const ContentCache::Entry& entry);
+    static bool         isMissCacheable(const HttpRequest& req, const NegativeCache& misses);
+    static HttpResponse getMissing(const HttpRequest& req, NegativeCache& misses, ErrorPages& pages);
+    static HttpResponse getCachedMiss(const NegativeCache::Entry& entry);
+    static bool         isNotModified(const HttpRequest& req, const std::string& etag, time_t mtime);
+    static HttpResponse getNotModified(const std::string& etag, const std::string& lastModified);
+    static bool         isRangeFresh(const HttpRequest& req, const std::string& etag, time_t mtime);
+    static bool         parseRange(const std::string& value, off_t size, std::vector<std::pair<off_t, off_t> >& ranges);
+    static bool         parseOffset(const std::string& digits, off_t& offset);
+    static const OpenFileCache::File* findPrecompressed(const HttpRequest& req, const std::string& path,
+                                                        OpenFileCache& cache, std::string& encoding);
+    static float        getAcceptQuality(const std::string& accept, const std::string& coding);
 
-    static std::string  generateDefaultErrorPage(HttpStatus s);
     static std::string  generateAutoindex(const HttpRequest& req);
 };
 
@@ -6,20 +6,19 @@ HttpDataFecther::~HttpDataFecther() {}
 
 std::string HttpDataFecther::fetch() const {
   std::string _data;
-  struct stat _stat;
 
-  if (stat(this->req.getTargetPath().c_str(), &_stat) == -1)
+  if (!this->req.isTargetFound())
     throw NOT_FOUND;
 
-  if (S_ISDIR(_stat.st_mode)) {
+  if (this->req.isTargetDir()) {
     if (this->req.getLocationConfig().isAutoindex())
       _data = autoindex();
     else if (this->req.getLocationConfig().getIndex() != "")
-      _data = readFile(this->req.getTargetPath() + this->req.getLocationConfig().getIndex());
+      _data = readFile(this->req.getResolvedPath());
     else
       throw NOT_FOUND;
   }
-  else if (S_ISREG(_stat.st_mode))
+  else if (S_ISREG(this->req.getTargetStat().st_mode))
     _data = readFile(this->req.getTargetPath());
   else
     throw FORBIDDEN;
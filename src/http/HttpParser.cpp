@@ -0,0 +1,229 @@
+#include "./HttpParser.hpp"
+
+HttpParser::HttpParser() {
+  reset();
+}
+
+HttpParser::~HttpParser() {}
+
+HttpParser::HttpParser(const HttpParser& obj) {
+  *this = obj;
+}
+
+HttpParser& HttpParser::operator=(const HttpParser& obj) {
+  if (this != &obj) {
+    this->state = obj.state;
+    this->pos = obj.pos;
+    this->mark = obj.mark;
+    this->value_end = obj.value_end;
+    this->method = obj.method;
+    this->target = obj.target;
+    this->version = obj.version;
+    this->fields = obj.fields;
+    this->chunked = obj.chunked;
+    this->has_length = obj.has_length;
+    this->content_length = obj.content_length;
+  }
+  return *this;
+}
+
+void HttpParser::reset() {
+  this->state = REQUEST_START;
+  this->pos = 0;
+  this->mark = 0;
+  this->value_end = 0;
+  this->method = Span(0, 0);
+  this->target = Span(0, 0);
+  this->version = Span(0, 0);
+  this->fields.clear();
+  this->chunked = false;
+  this->has_length = false;
+  this->content_length = 0;
+}
+
+/*
+ * -------------------------- Parse -------------------------------
+ */
+
+HttpParser::Result HttpParser::execute(const std::string& buf) {
+  const size_t  len = buf.length();
+  size_t        i = this->pos;
+
+  while (i < len && this->state != HEADER_DONE) {
+    char c = buf[i];
+
+    switch (this->state) {
+      case REQUEST_START:
+        // Empty lines before the request line are ignored
+        if (c == '\r' || c == '\n')
+          break;
+        if (!isToken(c))
+          throw BAD_REQUEST;
+        this->mark = i;
+        this->state = METHOD;
+        break;
+
+      case METHOD:
+        if (c == ' ') {
+          this->method = Span(this->mark, i - this->mark);
+          this->mark = i + 1;
+          this->state = TARGET;
+        }
+        else if (!isToken(c))
+          throw BAD_REQUEST;
+        break;
+
+      case TARGET:
+        if (c == ' ') {
+          if (i == this->mark)
+            throw BAD_REQUEST;
+          this->target = Span(this->mark, i - this->mark);
+          this->mark = i + 1;
+          this->state = VERSION;
+        }
+        else if (c == '\r' || c == '\n')
+          throw BAD_REQUEST;
+        break;
+
+      case VERSION:
+        if (c == '\r' || c == '\n') {
+          if (i == this->mark)
+            throw BAD_REQUEST;
+          this->version = Span(this->mark, i - this->mark);
+          this->state = (c == '\r') ? REQUEST_LINE_LF : FIELD_START;
+        }
+        else if (c == ' ')
+          throw BAD_REQUEST;
+        break;
+
+      case REQUEST_LINE_LF:
+        if (c != '\n')
+          throw BAD_REQUEST;
+        this->state = FIELD_START;
+        break;
+
+      case FIELD_START:
+        if (c == '\r')
+          this->state = HEADER_LF;
+        else if (c == '\n')
+          this->state = HEADER_DONE;
+        else if (c == ':' || c == ' ' || c == '\t')
+          throw BAD_REQUEST;
+        else {
+          this->mark = i;
+          this->state = FIELD_NAME;
+        }
+        break;
+
+      case FIELD_NAME:
+        if (c == ':') {
+          this->fields.push_back(Field(Span(this->mark, i - this->mark), Span(i + 1, 0)));
+          this->state = VALUE_START;
+        }
+        else if (c == '\r' || c == '\n')
+          throw BAD_REQUEST;
+        break;
+
+      case VALUE_START:
+        if (c == ' ' || c == '\t')
+          break;
+        this->mark = i;
+        this->value_end = i;
+        this->state = VALUE;
+        // fall through
+      case VALUE:
+        if (c == '\r' || c == '\n') {
+          this->fields.back().second = Span(this->mark, this->value_end - this->mark);
+          endField(buf);
+          this->state = (c == '\r') ? FIELD_LF : FIELD_START;
+        }
+        else if (c != ' ' && c != '\t')
+          this->value_end = i + 1;
+        break;
+
+      case FIELD_LF:
+        if (c != '\n')
+          throw BAD_REQUEST;
+        this->state = FIELD_START;
+        break;
+
+      case HEADER_LF:
+        if (c != '\n')
+          throw BAD_REQUEST;
+        this->state = HEADER_DONE;
+        break;
+
+      case HEADER_DONE:
+        break;
+    }
+    ++i;
+  }
+
+  this->pos = i;
+  return this->state == HEADER_DONE ? DONE : AGAIN;
+}
+
+// Body framing is decided while the fields go by, no second lookup
+void HttpParser::endField(const std::string& buf) {
+  const Field& field = this->fields.back();
+
+  if (equalsNoCase(buf, field.first, "transfer-encoding"))
+    this->chunked = equalsNoCase(buf, field.second, "chunked");
+  else if (equalsNoCase(buf, field.first, "content-length")) {
+    long long n = 0;
+
+    if (field.second.second == 0)
+      throw BAD_REQUEST;
+    for (size_t k = field.second.first; k < field.second.first + field.second.second; ++k) {
+      if (buf[k] < '0' || buf[k] > '9')
+        throw BAD_REQUEST;
+      n = n * 10 + (buf[k] - '0');
+      if (n > INT_MAX)
+        throw PAYLOAD_TOO_LARGE;
+    }
+    this->has_length = true;
+    this->content_length = static_cast<int>(n);
+  }
+}
+
+bool HttpParser::isToken(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || (c != '\0' && std::strchr("!#$%&'*+-.^_`|~", c));
+}
+
+bool HttpParser::equalsNoCase(const std::string& buf, const Span& span, const char* s) {
+  size_t k = 0;
+
+  for (; s[k]; ++k) {
+    if (k >= span.second || std::tolower(static_cast<unsigned char>(buf[span.first + k])) != s[k])
+      return false;
+  }
+  return k == span.second;
+}
+
+std::string HttpParser::str(const std::string& buf, const Span& span) {
+  return buf.substr(span.first, span.second);
+}
+
+/*
+ * -------------------------- Getter -------------------------------
+ */
+
+const HttpParser::Span& HttpParser::getMethod() const { return this->method; }
+
+const HttpParser::Span& HttpParser::getTarget() const { return this->target; }
+
+const HttpParser::Span& HttpParser::getVersion() const { return this->version; }
+
+const std::vector<HttpParser::Field>& HttpParser::getFields() const { return this->fields; }
+
+size_t HttpParser::getHeaderLength() const { return this->pos; }
+
+HttpParser::Framing HttpParser::getFraming() const {
+  if (this->chunked)
+    return CHUNKED;
+  if (this->has_length)
+    return LENGTH;
+  return NONE;
+}
+
+int HttpParser::getContentLength() const { return this->content_length; }
@@ -0,0 +1,95 @@
+#ifndef HTTP_PARSER_HPP
+# define HTTP_PARSER_HPP
+
+# include "./HttpStatus.hpp"
+
+# include <string>
+# include <vector>
+# include <utility>
+# include <cctype>
+# include <climits>
+# include <cstring>
+
+/*
+ * Resumable request line and header parser.
+ * execute() walks the receive buffer one byte at a time from where the
+ * previous call stopped, so a request that arrives in many pieces is
+ * still parsed in a single pass. Results are offsets into that buffer,
+ * the buffer must not be modified before the header is DONE and consumed.
+ * Malformed input throws HttpStatus, like the rest of the request parsing.
+ */
+class HttpParser {
+  public:
+    enum Result {
+      AGAIN,
+      DONE
+    };
+
+    enum Framing {
+      NONE,
+      LENGTH,
+      CHUNKED
+    };
+
+    // offset, length
+    typedef std::pair<size_t, size_t> Span;
+    // name, value
+    typedef std::pair<Span, Span>     Field;
+
+    HttpParser();
+    ~HttpParser();
+    HttpParser(const HttpParser& obj);
+    HttpParser&                 operator=(const HttpParser& obj);
+
+    Result                      execute(const std::string& buf);
+    void                        reset();
+
+    static std::string          str(const std::string& buf, const Span& span);
+
+    const Span&                 getMethod() const;
+    const Span&                 getTarget() const;
+    const Span&                 getVersion() const;
+    const std::vector<Field>&   getFields() const;
+    // bytes of the request line and the header, including the empty line
+    size_t                      getHeaderLength() const;
+
+    Framing                     getFraming() const;
+    int                         getContentLength() const;
+
+  private:
+    enum State {
+      REQUEST_START,
+      METHOD,
+      TARGET,
+      VERSION,
+      REQUEST_LINE_LF,
+      FIELD_START,
+      FIELD_NAME,
+      VALUE_START,
+      VALUE,
+      FIELD_LF,
+      HEADER_LF,
+      HEADER_DONE
+    };
+
+    State                       state;
+    size_t                      pos;
+    size_t                      mark;
+    // end of the value without its trailing whitespace
+    size_t                      value_end;
+
+    Span                        method;
+    Span                        target;
+    Span                        version;
+    std::vector<Field>          fields;
+
+    bool                        chunked;
+    bool                        has_length;
+    int                         content_length;
+
+    void                        endField(const std::string& buf);
+    static bool                 isToken(char c);
+    static bool                 equalsNoCase(const std::string& buf, const Span& span, const char* s);
+};
+
+#endif
@@ -3,12 +3,22 @@
 const size_t HttpRequest::URL_MAX_LENGTH = 2000;
 
 HttpRequest::HttpRequest():
+  body_length(0),
+  body_fd(-1),
+  body_held(false),
   header(),
+  sc(NULL),
+  lc(NULL),
   cgi(false),
+  targetFound(false),
+  statWrites(0),
+  mimeType(NULL),
+  _handler(FILE_HANDLER),
   recv_status(HEADER_RECEIVE),
   contentLength(0),
-  errorStatusCode(BAD_REQUEST)
-{}
+  errorStatusCode(BAD_REQUEST) {
+  std::memset(&this->targetStat, 0, sizeof(this->targetStat));
+}
 
 HttpRequest::~HttpRequest() {}
 
@@ -18,6 +28,10 @@ HttpRequest::HttpRequest(const HttpRequest& obj):
   queryString(obj.queryString),
   version(obj.version),
   body(obj.body),
+  body_length(obj.body_length),
+  body_fd(obj.body_fd),
+  body_path(obj.body_path),
+  body_held(obj.body_held),
   header(obj.header),
   sc(obj.sc),
   lc(obj.lc),
@@ -25,6 +39,14 @@ HttpRequest::HttpRequest(const HttpRequest& obj):
   scriptPath(obj.scriptPath),
   cgiPath(obj.getCGIPath()),
   pathInfo(obj.pathInfo),
+  substitutedPath(obj.substitutedPath),
+  targetPath(obj.targetPath),
+  resolvedPath(obj.resolvedPath),
+  targetFound(obj.targetFound),
+  targetStat(obj.targetStat),
+  statWrites(obj.statWrites),
+  mimeType(obj.mimeType),
+  _handler(obj._handler),
   recv_status(obj.recv_status),
   contentLength(obj.contentLength),
   errorStatusCode(obj.errorStatusCode) {
@@ -37,6 +59,10 @@ HttpRequest& HttpRequest::operator=(const HttpRequest& obj) {
     this->queryString = obj.queryString;
     this->version = obj.version;
     this->body = obj.body;
+    this->body_length = obj.body_length;
+    this->body_fd = obj.body_fd;
+    this->body_path = obj.body_path;
+    this->body_held = obj.body_held;
     this->header = obj.header;
     this->sc = obj.sc;
     this->lc = obj.lc;
@@ -44,6 +70,14 @@ HttpRequest& HttpRequest::operator=(const HttpRequest& obj) {
     this->scriptPath = obj.scriptPath;
     this->cgiPath = obj.getCGIPath();
     this->pathInfo = obj.pathInfo;
+    this->substitutedPath = obj.substitutedPath;
+    this->targetPath = obj.targetPath;
+    this->resolvedPath = obj.resolvedPath;
+    this->targetFound = obj.targetFound;
+    this->targetStat = obj.targetStat;
+    this->statWrites = obj.statWrites;
+    this->mimeType = obj.mimeType;
+    this->_handler = obj._handler;
     this->recv_status = obj.recv_status;
     this->contentLength = obj.contentLength;
     this->errorStatusCode = obj.errorStatusCode;
@@ -52,33 +86,48 @@ HttpRequest& HttpRequest::operator=(const HttpRequest& obj) {
   return *this;
 }
 
-void HttpRequest::parse(const std::string& req, const Config& conf) {
-  size_t pos;
-
+void HttpRequest::parse(const std::string& buf, const HttpParser& parser, const Config& conf, int listen,
+                        NegativeCache& misses) {
     // Request line & header
-    if ((pos = req.find("\r\n")) != std::string::npos) {
-      parseStatusLine(req.substr(0, pos));
-      this->header.parse(req.substr(pos + 2));
-    }
-    else
-      parseStatusLine(req);
+    setMethod(HttpParser::str(buf, parser.getMethod()));
+    setURI(HttpParser::str(buf, parser.getTarget()));
+    setVersion(HttpParser::str(buf, parser.getVersion()));
+    this->header.parse(buf, parser.getFields());
 
     // Set config
     std::string host = this->header.get(HttpRequestHeader::HOST);
-    this->sc = conf.getHttpConfig().findServerConfig(host);
-    this->lc = this->sc.findLocationConfig(this->getPath());
+    this->sc = &conf.getHttpConfig().findServerConfig(listen, host);
+    this->lc = &this->sc->findLocationConfig(this->getPath());
 
-    // setup CGI
-    setupCGI();
+    resolve(conf.getHttpConfig().getTypes(), misses);
 }
 
-void HttpRequest::parseStatusLine(const std::string& line) {
-  std::vector<std::string> vs = util::split(line, ' ');
-  if (vs.size() != 3) throw BAD_REQUEST;
+/*
+ * Everything the handlers ask of the target, computed once here: the
+ * path after alias and root, its stat, the index fallback, the MIME type
+ * and the handler. A return location never touches the filesystem.
+ */
+void HttpRequest::resolve(const MimeType& types, NegativeCache& misses) {
+  this->substitutedPath = substitutePath();
+  this->targetPath = "." + this->substitutedPath;
+  this->resolvedPath = this->targetPath;
+  if (getLocationConfig().hasReturn()) {
+    this->_handler = RETURN_HANDLER;
+    return;
+  }
+
+  // A path known missing is not stat'ed again
+  this->statWrites = NegativeCache::getWrites();
+  if (misses.find(this->targetPath, getLocationConfig()) != NULL)
+    this->targetFound = false;
+  else
+    this->targetFound = (stat(this->targetPath.c_str(), &this->targetStat) == 0);
+  if (isTargetDir() && !getLocationConfig().getIndex().empty())
+    this->resolvedPath += getLocationConfig().getIndex();
+  this->mimeType = &types.getMimeType(this->resolvedPath);
 
-  setMethod(vs[0]);
-  setURI(vs[1]);
-  setVersion(vs[2]);
+  setupCGI();
+  this->_handler = this->cgi ? CGI_HANDLER : FILE_HANDLER;
 }
 
 void HttpRequest::validateMethod(const std::string &method) {
@@ -119,63 +168,22 @@ void HttpRequest::validateVersion(const std::string &version) {
 }
 
 void HttpRequest::setupCGI() {
-  size_t                                        reqPathPos;
-  std::string                                   reqPath = getPath();
-  std::map<std::string, std::string>::iterator  it;
-  std::map<std::string, std::string>            cgi = this->sc.getCGI();
-
-  for (it = cgi.begin(); it != cgi.end(); ++it) {
-    std::string targetPath = getTargetPath();
-    std::string ext = it->first;
-    std::string cgiPath = it->second;
-    size_t      targetPathPos;
-
-    if ((reqPathPos = reqPath.find(ext)) != std::string::npos) {
-      this->cgi = true;
-      if ((targetPathPos = targetPath.find(ext)) != std::string::npos)
-        this->scriptPath = targetPath.substr(0, targetPathPos + ext.length());
-      else
-        throw BAD_REQUEST;
-      this->pathInfo = getPath().substr(reqPathPos + ext.length());
-      this->cgiPath = cgiPath;
-      break;
-    }
-  }
-}
+  const std::pair<std::string, std::string>* entry = getServerConfig().findCGI(this->path);
 
-void HttpRequest::unchunkBody(void) {
-  std::string       ret;
-  std::string       s;
-  size_t            s_pos = 0;
-  size_t            e_pos;
-  bool              is_hex = true;
-  size_t            read_size = 0;
-
-  while ((e_pos = this->body.find("\r\n", s_pos)) != std::string::npos) {
-    s = this->body.substr(s_pos, e_pos - s_pos);
-
-    if (is_hex == true)
-      read_size = strToHex(s);
-    else if (read_size == 0)
-      break;
-    else if (read_size == s.size())
-      ret += s;
-    else
-      throw (BAD_REQUEST);
-    s_pos = e_pos + 2;
-    is_hex = !is_hex;
-  }
-
-  this->body = ret;
-}
+  if (entry == NULL)
+    return;
 
-unsigned int HttpRequest::strToHex(std::string s) {
-  unsigned int      ret;
-  std::stringstream ss(s);
+  const std::string& ext = entry->first;
+  size_t             reqPathPos = this->path.find(ext);
+  size_t             targetPathPos;
 
-  ss >> std::hex >> ret;
-
-  return ret;
+  this->cgi = true;
+  if ((targetPathPos = this->targetPath.find(ext)) != std::string::npos)
+    this->scriptPath = this->targetPath.substr(0, targetPathPos + ext.length());
+  else
+    throw BAD_REQUEST;
+  this->pathInfo = getPath().substr(reqPathPos + ext.length());
+  this->cgiPath = entry->second;
 }
 
 /*
@@ -192,14 +200,15 @@ bool HttpRequest::isMethod(std::string method) const {
 
 std::string HttpRequest::getPath() const { return this->path; }
 
-std::string HttpRequest::getSubstitutedPath() const {
+std::string HttpRequest::substitutePath() const {
   std::string root_path = getLocationConfig().getRoot();
   std::string alias_path = getLocationConfig().getAlias();
   std::string req_path = getPath();
   std::string loc_path = getLocationConfig().getPath();
   size_t      loc_path_len = getLocationConfig().getPath().length();
 
-  if (req_path.find(loc_path) != std::string::npos) {
+  // A regex location has no path part to replace, only root applies
+  if (!getLocationConfig().isRegex() && req_path.find(loc_path) != std::string::npos) {
 
     if (alias_path != "" && req_path != "/" && (req_path.length() == loc_path_len || req_path[loc_path_len] == '/')) {
       if (loc_path != req_path && alias_path == "/")
@@ -217,7 +226,23 @@ std::string HttpRequest::getSubstitutedPath() const {
   return req_path;
 }
 
-std::string HttpRequest::getTargetPath() const { return "." + getSubstitutedPath(); }
+const std::string& HttpRequest::getSubstitutedPath() const { return this->substitutedPath; }
+
+const std::string& HttpRequest::getTargetPath() const { return this->targetPath; }
+
+const std::string& HttpRequest::getResolvedPath() const { return this->resolvedPath; }
+
+bool HttpRequest::isTargetFound() const { return this->targetFound; }
+
+bool HttpRequest::isTargetDir() const { return this->targetFound && S_ISDIR(this->targetStat.st_mode); }
+
+const struct stat& HttpRequest::getTargetStat() const { return this->targetStat; }
+
+NegativeCache::Generation HttpRequest::getStatWrites() const { return this->statWrites; }
+
+HttpRequest::handler HttpRequest::getHandler() const { return this->_handler; }
+
+bool HttpRequest::isHandler(handler h) const { return this->_handler == h; }
 
 std::string HttpRequest::getQueryString() const { return this->queryString; }
 
@@ -230,31 +255,23 @@ std::string HttpRequest::getBody() const {
 }
 
 const std::string HttpRequest::getContentType(void) const {
-  std::string content_type;
-  std::string path;
-  MimeType    mt;
-  struct stat _stat;
+  std::string content_type = getHeader().get(HttpRequestHeader::CONTENT_TYPE);
 
-  content_type = getHeader().get(HttpRequestHeader::CONTENT_TYPE);
-  if (content_type != "")
+  if (!content_type.empty() || this->mimeType == NULL)
     return content_type;
-
-  if (stat(this->getTargetPath().c_str(), &_stat) == -1)
-    path = this->getTargetPath();
-  else if (S_ISDIR(_stat.st_mode) && this->getLocationConfig().getIndex() != "")
-    path = this->getTargetPath() + this->getLocationConfig().getIndex();
-  else
-    path = this->getTargetPath();
-
-  return mt.getMimeType(path);
+  return *this->mimeType;
 }
 
 const LocationConfig& HttpRequest::getLocationConfig() const {
-  return this->lc;
+  static const LocationConfig none;
+
+  return this->lc ? *this->lc : none;
 }
 
 const ServerConfig& HttpRequest::getServerConfig() const {
-  return this->sc;
+  static const ServerConfig none;
+
+  return this->sc ? *this->sc : none;
 }
 
 bool HttpRequest::isCGI() const {
@@ -291,7 +308,73 @@ HttpStatus HttpRequest::getErrorStatusCode() const {
  * -------------------------- Setter -------------------------------
  */
 
-void HttpRequest::setBody(const std::string& body) { this->body = body; }
+void HttpRequest::setBody(const std::string& body) {
+  this->body = body;
+  this->body_length = body.length();
+}
+
+void HttpRequest::appendBody(const char* data, size_t len) {
+  this->body_length += len;
+  if (this->body_fd == -1 || this->body_held) {
+    this->body.append(data, len);
+    return;
+  }
+
+  while (len > 0) {
+    ssize_t n = write(this->body_fd, data, len);
+    if (n <= 0)
+      throw INTERNAL_SERVER_ERROR;
+    data += n;
+    len -= n;
+  }
+}
+
+size_t HttpRequest::getBodyLength() const { return this->body_length; }
+
+void HttpRequest::addBodyLength(size_t len) { this->body_length += len; }
+
+void HttpRequest::setBodyFile(int fd, const std::string& path) {
+  this->body_fd = fd;
+  this->body_path = path;
+}
+
+bool HttpRequest::isBodyInFile() const { return !this->body_path.empty(); }
+
+int HttpRequest::getBodyFd() const { return this->body_fd; }
+
+void HttpRequest::commitBodyFile(const std::string& target) {
+  std::string path = this->body_path;
+
+  close(this->body_fd);
+  this->body_fd = -1;
+  this->body_path.clear();
+  if (rename(path.c_str(), target.c_str()) == -1) {
+    unlink(path.c_str());
+    throw FORBIDDEN;
+  }
+}
+
+// An upload that never completed leaves nothing behind
+void HttpRequest::discardBodyFile() {
+  if (this->body_fd != -1)
+    close(this->body_fd);
+  if (!this->body_path.empty())
+    unlink(this->body_path.c_str());
+  this->body_fd = -1;
+  this->body_path.clear();
+}
+
+void HttpRequest::holdBodyWrites() { this->body_held = true; }
+
+off_t HttpRequest::takeHeldBody(std::string& out) {
+  out.clear();
+  out.swap(this->body);
+  return this->body_length - out.length();
+}
+
+void HttpRequest::addTrailers(const std::vector<std::pair<std::string, std::string> >& trailers) {
+  this->header.addTrailers(trailers);
+}
 
 void HttpRequest::setURI(const std::string& URI) {
   validateURI(URI);
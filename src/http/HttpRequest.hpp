@@ -2,13 +2,17 @@
 # define HTTP_REQUEST_HPP
 
 # include "./header/HttpRequestHeader.hpp"
+# include "./HttpParser.hpp"
 # include "./HttpStatus.hpp"
 # include "./MimeType.hpp"
+# include "./NegativeCache.hpp"
 # include "../etc/Util.hpp"
 # include "../config/Config.hpp"
 # include "../etc/Logger.hpp"
 
+# include <cstdio>
 # include <cstring>
+# include <unistd.h>
 # include <sys/stat.h>
 # include <sstream>
 # include <stdexcept>
@@ -34,19 +38,37 @@ class HttpRequest {
       RECEIVE_ERROR
     };
 
+    // What serves the request, settled once the header is parsed
+    enum handler {
+      RETURN_HANDLER,
+      CGI_HANDLER,
+      FILE_HANDLER
+    };
+
     HttpRequest();
     ~HttpRequest();
     HttpRequest& operator=(const HttpRequest& obj);
     HttpRequest(const HttpRequest& obj);
 
-    void                                  parse(const std::string& req, const Config& conf);
-    void                                  unchunkBody();
+    // buf is the receive buffer the parser ran on, listen the address group of the client,
+    // misses the paths of the loop known missing
+    void                                  parse(const std::string& buf, const HttpParser& parser, const Config& conf, int listen,
+                                                NegativeCache& misses);
 
     std::string                           getMethod() const;
     bool                                  isMethod(std::string method) const;
     std::string                           getPath() const;
-    std::string                           getSubstitutedPath() const;
-    std::string                           getTargetPath() const;
+    // The resolved target below is computed once by parse(), never again
+    const std::string&                    getSubstitutedPath() const;
+    const std::string&                    getTargetPath() const;
+    // The target, or its index file when the target is a directory
+    const std::string&                    getResolvedPath() const;
+    bool                                  isTargetFound() const;
+    bool                                  isTargetDir() const;
+    const struct stat&                    getTargetStat() const;
+    NegativeCache::Generation             getStatWrites() const;
+    handler                               getHandler() const;
+    bool                                  isHandler(handler h) const;
     std::string                           getQueryString() const;
     std::string                           getVersion() const;
     const HttpRequestHeader&              getHeader() const;
@@ -64,6 +86,21 @@ class HttpRequest {
     HttpStatus                            getErrorStatusCode() const;
 
     void                                  setBody(const std::string& body);
+    // Goes to the body file once one is set, to memory otherwise
+    void                                  appendBody(const char* data, size_t len);
+    size_t                                getBodyLength() const;
+    void                                  addBodyLength(size_t len);
+
+    void                                  setBodyFile(int fd, const std::string& path);
+    bool                                  isBodyInFile() const;
+    int                                   getBodyFd() const;
+    void                                  commitBodyFile(const std::string& target);
+    void                                  discardBodyFile();
+    // The loop writes the body file itself, appendBody only keeps the bytes
+    void                                  holdBodyWrites();
+    // The kept bytes, moved to out, and the file offset they go to
+    off_t                                 takeHeldBody(std::string& out);
+    void                                  addTrailers(const std::vector<std::pair<std::string, std::string> >& trailers);
 
     void                                  setRecvStatus(recvStatus status);
     void                                  setContentLength(int len);
@@ -78,20 +115,37 @@ class HttpRequest {
     std::string                           queryString;
     std::string                           version;
     std::string                           body;
+    size_t                                body_length;
+    int                                   body_fd;
+    std::string                           body_path;
+    bool                                  body_held;
     HttpRequestHeader                     header;
-    ServerConfig                          sc;
-    LocationConfig                        lc;
+    // Into the config, which outlives every request, NULL until parse()
+    const ServerConfig*                   sc;
+    const LocationConfig*                 lc;
 
     bool                                  cgi;
     std::string                           scriptPath;
     std::string                           cgiPath;
     std::string                           pathInfo;
 
+    std::string                           substitutedPath;
+    std::string                           targetPath;
+    std::string                           resolvedPath;
+    bool                                  targetFound;
+    struct stat                           targetStat;
+    // NegativeCache writes counted before the target was stat'ed
+    NegativeCache::Generation             statWrites;
+    // MIME type of resolvedPath, into the config's types, NULL until parse()
+    const std::string*                    mimeType;
+    handler                               _handler;
+
     recvStatus                            recv_status;
     int                                   contentLength;
     HttpStatus                            errorStatusCode;
 
-    void                                  parseStatusLine(const std::string &line);
+    void                                  resolve(const MimeType& types, NegativeCache& misses);
+    std::string                           substitutePath() const;
     void                                  setupCGI();
 
     void                                  setURI(const std::string& URI);
@@ -101,7 +155,6 @@ class HttpRequest {
     void                                  validateMethod(const std::string &method);
     void                                  validateVersion(const std::string &path);
     void                                  validateURI(const std::string &version);
-    unsigned int                          strToHex(std::string s);
 };
 
 #endif
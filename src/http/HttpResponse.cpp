@@ -11,15 +11,21 @@ HttpResponse::HttpResponse():
   statusText(""),
   header(),
   body(""),
+  cachedHead(),
+  sharedBody(),
   isSetBuffer(false),
-  buffer(""),
-  buffer_size(0),
-  sendLength(0),
+  output(),
   cgi_stat(NOT_CGI),
   cgi(),
   fileFd(-1),
   fileBuffer(""),
   offset(0),
+  bodyOmitted(false),
+  fileBody(false),
+  fileSize(0),
+  fileRanges(),
+  partHeads(),
+  gzipLevel(0),
   error(false) {
 }
 
@@ -28,15 +34,21 @@ HttpResponse::HttpResponse(const HttpResponse& obj):
   statusText(obj.statusText),
   header(obj.header),
   body(obj.body),
+  cachedHead(obj.cachedHead),
+  sharedBody(obj.sharedBody),
   isSetBuffer(obj.isSetBuffer),
-  buffer(obj.buffer),
-  buffer_size(obj.buffer_size),
-  sendLength(obj.sendLength),
+  output(obj.output),
   cgi_stat(obj.cgi_stat),
   cgi(obj.cgi),
   fileFd(obj.fileFd),
   fileBuffer(obj.fileBuffer),
   offset(obj.offset),
+  bodyOmitted(obj.bodyOmitted),
+  fileBody(obj.fileBody),
+  fileSize(obj.fileSize),
+  fileRanges(obj.fileRanges),
+  partHeads(obj.partHeads),
+  gzipLevel(obj.gzipLevel),
   error(obj.error) {
 }
 
@@ -46,11 +58,11 @@ HttpResponse& HttpResponse::operator=(const HttpResponse& obj) {
     this->statusText = obj.statusText;
     this->header = obj.header;
     this->body = obj.body;
+    this->cachedHead = obj.cachedHead;
+    this->sharedBody = obj.sharedBody;
 
     this->isSetBuffer = obj.isSetBuffer;
-    this->buffer = obj.buffer;
-    this->buffer_size = obj.buffer_size;
-    this->sendLength = obj.sendLength;
+    this->output = obj.output;
 
     this->cgi_stat = obj.cgi_stat;
     this->cgi = obj.cgi;
@@ -60,6 +72,12 @@ HttpResponse& HttpResponse::operator=(const HttpResponse& obj) {
     this->fileBuffer = obj.fileBuffer;
 
     this->offset = obj.offset;
+    this->bodyOmitted = obj.bodyOmitted;
+    this->fileBody = obj.fileBody;
+    this->fileSize = obj.fileSize;
+    this->fileRanges = obj.fileRanges;
+    this->partHeads = obj.partHeads;
+    this->gzipLevel = obj.gzipLevel;
     this->error = obj.error;
   }
 
@@ -85,7 +103,7 @@ HttpStatus HttpResponse::getStatusCode() const {
 }
 
 HttpResponse::SendStatus HttpResponse::getSendStatus() const {
-  if (this->isSetBuffer == true && this->buffer_size == this->sendLength)
+  if (this->isSetBuffer == true && this->output.empty())
     return DONE;
   return SENDING;
 }
@@ -94,10 +112,6 @@ HttpResponse::SendStatus HttpResponse::getSendStatus() const {
  * -------------------------- Setter -------------------------------
  */
 
-void HttpResponse::addSendLength(unsigned int length) {
-  this->sendLength += length;
-}
-
 void HttpResponse::setStatusCode(const HttpStatus statusCode) {
   this->statusCode = statusCode;
 }
@@ -106,31 +120,106 @@ void HttpResponse::setBody(const std::string& body) {
   this->body = body;
 }
 
-void HttpResponse::removeBody() {
-  this->body = "";
+void HttpResponse::omitBody() {
+  this->bodyOmitted = true;
+  if (this->fileBody && this->fileFd != -1) {
+    close(this->fileFd);
+    this->fileFd = -1;
+  }
 }
 
-std::string HttpResponse::toString() throw() {
-  std::string ret;
+OutputChain& HttpResponse::getOutput() {
+  if (this->isSetBuffer == false)
+    serialize();
+  return this->output;
+}
 
-  if (this->isSetBuffer == true)
-    return this->buffer.substr(this->sendLength);
+void HttpResponse::serialize() {
+  std::string head;
+  bool        chunked = false;
 
   this->statusText = getStatusText(this->statusCode);
-  this->header.set(HttpResponseHeader::CONTENT_LENGTH, util::itoa(body.length()));
-  this->header.set(HttpResponseHeader::DATE, getCurrentTimeStr());
+  if (this->gzipLevel > 0 && !this->bodyOmitted)
+    chunked = deflateBody();
+  // A 304 neither has nor describes a body
+  if (this->statusCode == NOT_MODIFIED)
+    ;
+  else if (chunked)
+    this->header.set(HttpResponseHeader::TRANSFER_ENCODING, "chunked");
+  else
+    this->header.set(HttpResponseHeader::CONTENT_LENGTH, util::ltoa(getBodyLength()));
   this->header.set(HttpResponseHeader::SERVER, "webserv/1.0");
+  this->header.set(HttpResponseHeader::DATE, getCurrentTimeStr());
 
-  ret = makeStatusLine();
-  ret += this->header.toStringForResponse();
-  ret += "\r\n";
-  ret += this->body;
-
-  this->buffer = ret;
-  this->buffer_size = ret.length();
+  head = makeStatusLine();
+  head += this->cachedHead;
+  head += this->header.toStringForResponse();
+  head += "\r\n";
+
+  this->output.append(head);
+  if (!this->bodyOmitted) {
+    this->output.append(this->body);
+    this->output.append(this->sharedBody);
+    if (this->fileBody && this->fileRanges.empty())
+      this->output.appendFile(this->fileFd, 0, this->fileSize);
+    for (size_t i = 0; i < this->fileRanges.size(); ++i) {
+      if (!this->partHeads.empty())
+        this->output.append(this->partHeads[i]);
+      this->output.appendFile(this->fileFd, this->fileRanges[i].first,
+                              this->fileRanges[i].second - this->fileRanges[i].first + 1);
+    }
+    if (!this->partHeads.empty())
+      this->output.append(this->partHeads.back());
+  }
   this->isSetBuffer = true;
+}
+
+// True when the file body is left to the output chain, whose length is not known yet
+bool HttpResponse::deflateBody() {
+  bool streamed = false;
+
+  if (this->fileBody) {
+    if (!this->output.startGzip(this->gzipLevel))
+      return false;
+    streamed = true;
+  }
+  else {
+    Deflater    deflater;
+    std::string out;
+
+    if (!deflater.init(this->gzipLevel))
+      return false;
+    deflater.update(this->body.data(), this->body.length(), out);
+    deflater.update(this->sharedBody.data(), this->sharedBody.length(), out);
+    deflater.finish(out);
+    this->body.swap(out);
+    this->sharedBody = SharedBuffer();
+  }
+
+  // A length given by a CGI describes the identity body
+  this->header.remove(HttpResponseHeader::CONTENT_LENGTH);
+  this->header.set(HttpResponseHeader::CONTENT_ENCODING, "gzip");
+  // Same content, no longer the same bytes
+  std::string etag = this->header.get(HttpResponseHeader::ETAG);
+  if (!etag.empty() && etag[0] == '"') {
+    this->header.remove(HttpResponseHeader::ETAG);
+    this->header.set(HttpResponseHeader::ETAG, "W/" + etag);
+  }
+  return streamed;
+}
 
-  return ret;
+off_t HttpResponse::getBodyLength() const {
+  if (!this->fileBody)
+    return this->body.length() + this->sharedBody.length();
+  if (this->fileRanges.empty())
+    return this->fileSize;
+
+  off_t length = 0;
+  for (size_t i = 0; i < this->fileRanges.size(); ++i)
+    length += this->fileRanges[i].second - this->fileRanges[i].first + 1;
+  for (size_t i = 0; i < this->partHeads.size(); ++i)
+    length += this->partHeads[i].length();
+  return length;
 }
 
 std::string HttpResponse::makeStatusLine() const {
@@ -138,14 +227,7 @@ std::string HttpResponse::makeStatusLine() const {
 }
 
 std::string HttpResponse::getCurrentTimeStr() const {
-  time_t curr_time;
-  char buf[100];
-
-  curr_time = time(NULL);
-  tm *time = gmtime(&curr_time);
-  strftime(buf, 100, "%a, %d %b %Y %X GMT", time);
-
-  return buf;
+  return util::toHttpDate(time(NULL));
 }
 
 void HttpResponse::setCgiStatus(HttpResponse::CgiStatus s) {
@@ -213,3 +295,54 @@ void HttpResponse::addOffSet(int offset) {
 int HttpResponse::getOffSet(void) const {
   return this->offset;
 }
+
+void HttpResponse::setFileBody(off_t size) {
+  this->fileBody = true;
+  this->fileSize = size;
+}
+
+bool HttpResponse::isFileBody(void) const {
+  return this->fileBody;
+}
+
+void HttpResponse::setFileRanges(const std::vector<std::pair<off_t, off_t> >& ranges) {
+  std::string size = util::ltoa(this->fileSize);
+
+  this->fileRanges = ranges;
+  this->partHeads.clear();
+  if (ranges.size() == 1) {
+    this->header.set(HttpResponseHeader::CONTENT_RANGE, "bytes " + util::ltoa(ranges[0].first)
+                     + "-" + util::ltoa(ranges[0].second) + "/" + size);
+    return;
+  }
+
+  // Only has to stay out of the body. Built from this response alone, the
+  // etag and the ranges, no counter is shared between the reactor threads.
+  std::string boundary;
+  std::string etag = this->header.get(HttpResponseHeader::ETAG);
+  for (size_t i = 0; i < etag.length(); ++i)
+    if (std::isxdigit(static_cast<unsigned char>(etag[i])))
+      boundary += etag[i];
+  boundary += "x" + util::toHex(ranges.size()) + "x" + util::toHex(ranges[0].first);
+  std::string type = this->header.get(HttpResponseHeader::CONTENT_TYPE);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    std::string part = "\r\n--" + boundary + "\r\n";
+    if (!type.empty())
+      part += "Content-Type: " + type + "\r\n";
+    part += "Content-Range: bytes " + util::ltoa(ranges[i].first) + "-"
+            + util::ltoa(ranges[i].second) + "/" + size + "\r\n\r\n";
+    this->partHeads.push_back(part);
+  }
+  this->partHeads.push_back("\r\n--" + boundary + "--\r\n");
+  this->header.remove(HttpResponseHeader::CONTENT_TYPE);
+  this->header.set(HttpResponseHeader::CONTENT_TYPE, "multipart/byteranges; boundary=" + boundary);
+}
+
+void HttpResponse::setGzip(int level) {
+  this->gzipLevel = level;
+}
+
+void HttpResponse::setCachedBody(const std::string& head, const SharedBuffer& body) {
+  this->cachedHead = head;
+  this->sharedBody = body;
+}
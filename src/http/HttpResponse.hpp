@@ -5,10 +5,16 @@
 # include "./header/HttpResponseHeader.hpp"
 # include "./HttpStatus.hpp"
 # include "./HttpRequest.hpp"
+# include "../etc/Deflater.hpp"
 # include "../etc/Util.hpp"
+# include "../network/OutputChain.hpp"
 
+# include <cctype>
 # include <map>
 # include <string>
+# include <utility>
+# include <vector>
+# include <sys/types.h>
 
 class HttpResponse {
 
@@ -30,8 +36,8 @@ class HttpResponse {
 
     void                                setStatusCode(const HttpStatus statusCode);
     void                                setBody(const std::string& body);
-    void                                removeBody();
-    void                                addSendLength(unsigned int length);
+    // HEAD, the header still describes the body that is not sent
+    void                                omitBody();
 
     HttpStatus                          getStatusCode() const;
     SendStatus                          getSendStatus() const;
@@ -59,7 +65,22 @@ class HttpResponse {
     void                                addOffSet(int offset);
     int                                 getOffSet(void) const;
 
-    std::string                         toString() throw();
+    // head holds the serialized entity headers that go with body
+    void                                setCachedBody(const std::string& head, const SharedBuffer& body);
+
+    // The body is the whole file behind fileFd, sent after the header
+    void                                setFileBody(off_t size);
+    bool                                isFileBody(void) const;
+    // Narrows the file body to these [first, last] byte ranges, several go out as multipart/byteranges
+    void                                setFileRanges(const std::vector<std::pair<off_t, off_t> >& ranges);
+
+    // Sends the body gzip encoded, a file body deflated piece by piece in chunks
+    void                                setGzip(int level);
+    // What Content-Length is or would be without any encoding
+    off_t                               getBodyLength() const;
+
+    // Queues the status line, header and body once, sendData flushes it
+    OutputChain&                        getOutput();
 
   private:
     static const std::string            version;
@@ -68,11 +89,11 @@ class HttpResponse {
     std::string                         statusText;
     HttpResponseHeader                  header;
     std::string                         body;
+    std::string                         cachedHead;
+    SharedBuffer                        sharedBody;
 
     bool                                isSetBuffer;
-    std::string                         buffer;
-    unsigned int                        buffer_size;
-    unsigned int                        sendLength;
+    OutputChain                         output;
 
     CgiStatus                           cgi_stat;
     CGI                                 cgi;
@@ -84,8 +105,19 @@ class HttpResponse {
     std::string                         fileBuffer;
     int                                 offset;
 
+    bool                                bodyOmitted;
+    bool                                fileBody;
+    off_t                               fileSize;
+    std::vector<std::pair<off_t, off_t> > fileRanges;
+    // Part headers in front of each range, then the closing delimiter
+    std::vector<std::string>            partHeads;
+    // 0 leaves the body as it is
+    int                                 gzipLevel;
+
     bool                                error;
 
+    void                                serialize();
+    bool                                deflateBody();
     std::string                         makeStatusLine() const;
     std::string                         getCurrentTimeStr() const;
 };
@@ -1,46 +1,143 @@
 #include "MimeType.hpp"
 
+const std::string MimeType::DEFAULT_TYPE = "text/plain";
+
+bool MimeType::Entry::operator<(const Entry& other) const {
+  return this->extension < other.extension;
+}
+
+/*
+ * ==============================================
+ *                 Constructor
+ * ==============================================
+ */
+
 MimeType::MimeType() {
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".txt", "text/plain"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".html", "text/html"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".htm", "text/html"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".css", "text/css"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".js", "text/javascript"));
-
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".gif", "image/gif"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".png", "image/png"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".jpg", "image/jpg"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".jpeg", "image/jpeg"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".bmp", "image/bmp"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".webp", "image/webp"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".ico", "image/x-icon"));
-
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".midi", "audio/midi"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".mpeg", "audio/mpeg"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".ogg", "audio/ogg"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".wav", "audio/wav"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".mp3", "audio/mp3"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".flac", "audio/flac"));
-
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".webm", "vedio/webm"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".avi", "vedio/avi"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".mp4", "vedio/mp4"));
-
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".exe", "application/octet-stream"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".out", "application/octet-stream"));
-  this->mimeTypes.insert(std::pair<std::string, std::string>(".pdf", "application/pdf"));
-}
-
-const std::string MimeType::getMimeType(const std::string& filename) const {
-  size_t pos = filename.rfind(".");
-
-  if (pos == std::string::npos)
-    return "text/plain";
-  else {
-    std::string extension = filename.substr(pos);
-    if (this->mimeTypes.find(extension) != this->mimeTypes.end())
-      return this->mimeTypes.at(extension);
+  add("txt", "text/plain");
+  add("html", "text/html");
+  add("htm", "text/html");
+  add("css", "text/css");
+  add("js", "text/javascript");
+
+  add("gif", "image/gif");
+  add("png", "image/png");
+  add("jpg", "image/jpeg");
+  add("jpeg", "image/jpeg");
+  add("bmp", "image/bmp");
+  add("webp", "image/webp");
+  add("ico", "image/x-icon");
+
+  add("midi", "audio/midi");
+  add("mpeg", "audio/mpeg");
+  add("ogg", "audio/ogg");
+  add("wav", "audio/wav");
+  add("mp3", "audio/mp3");
+  add("flac", "audio/flac");
+
+  add("webm", "video/webm");
+  add("avi", "video/avi");
+  add("mp4", "video/mp4");
+
+  add("exe", "application/octet-stream");
+  add("out", "application/octet-stream");
+  add("pdf", "application/pdf");
+  compile();
+}
+
+MimeType::MimeType(const MimeType& obj):
+  entries(obj.entries) {}
+
+MimeType& MimeType::operator=(const MimeType& obj) {
+  if (this != &obj)
+    this->entries = obj.entries;
+  return *this;
+}
+
+/*
+ * ==============================================
+ *                 Destructor
+ * ==============================================
+ */
+
+MimeType::~MimeType() {}
+
+/*
+ * ==============================================
+ *                   Public
+ * ==============================================
+ */
+
+void MimeType::add(const std::string& extension, const std::string& type) {
+  Entry entry;
+
+  entry.extension = extension;
+  for (size_t i = 0; i < entry.extension.length(); ++i)
+    entry.extension[i] = std::tolower(static_cast<unsigned char>(entry.extension[i]));
+  entry.type = type;
+  this->entries.push_back(entry);
+}
+
+void MimeType::clear() {
+  this->entries.clear();
+}
+
+// Sorted by extension, of the same extension the last added is kept
+void MimeType::compile() {
+  std::vector<Entry> sorted;
+
+  std::stable_sort(this->entries.begin(), this->entries.end());
+  for (size_t i = 0; i < this->entries.size(); ++i) {
+    if (i + 1 < this->entries.size() && this->entries[i].extension == this->entries[i + 1].extension)
+      continue;
+    sorted.push_back(this->entries[i]);
   }
+  this->entries.swap(sorted);
+}
+
+const std::string& MimeType::getMimeType(const std::string& filename) const {
+  size_t dot = filename.rfind('.');
+  size_t slash = filename.rfind('/');
+
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    return DEFAULT_TYPE;
+
+  const char* extension = filename.c_str() + dot + 1;
+  size_t      length = filename.length() - dot - 1;
+  size_t      low = 0;
+  size_t      high = this->entries.size();
 
-  return "text/plain";
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    int    cmp = compare(this->entries[mid].extension, extension, length);
+
+    if (cmp == 0)
+      return this->entries[mid].type;
+    if (cmp < 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return DEFAULT_TYPE;
+}
+
+/*
+ * ==============================================
+ *                   Private
+ * ==============================================
+ */
+
+// extension against s lowered, in the order std::string sorts by
+int MimeType::compare(const std::string& extension, const char* s, size_t length) {
+  size_t n = std::min(extension.length(), length);
+
+  for (size_t i = 0; i < n; ++i) {
+    unsigned char a = extension[i];
+    unsigned char b = std::tolower(static_cast<unsigned char>(s[i]));
+
+    if (a != b)
+      return a < b ? -1 : 1;
+  }
+  if (extension.length() == length)
+    return 0;
+  return extension.length() < length ? -1 : 1;
 }
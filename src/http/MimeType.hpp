@@ -1,16 +1,48 @@
 #ifndef MIME_TYPE_HPP
 # define MIME_TYPE_HPP
 
-# include <map>
+# include <algorithm>
+# include <cctype>
 # include <string>
+# include <vector>
 
+/*
+ * Content types by file extension, the table of the types blocks or a
+ * small built-in one without them. It is filled while the config is
+ * parsed and sorted once by compile(), after which it is only read, from
+ * every thread. A lookup is a binary search over the lowercase
+ * extensions, comparing in place against the path: nothing is allocated
+ * and the type is handed out by reference.
+ */
 class MimeType {
   public:
+    // The built-in types
     MimeType();
-    const std::string getMimeType(const std::string& filename) const;
+    MimeType(const MimeType& obj);
+    MimeType&                   operator=(const MimeType& obj);
+    ~MimeType();
+
+    // An extension given again takes the later type
+    void                        add(const std::string& extension, const std::string& type);
+    void                        clear();
+    void                        compile();
+
+    // text/plain for an unknown extension
+    const std::string&          getMimeType(const std::string& filename) const;
 
   private:
-    std::map<std::string, std::string> mimeTypes;
+    struct Entry {
+      std::string               extension;
+      std::string               type;
+
+      bool                      operator<(const Entry& other) const;
+    };
+
+    static const std::string    DEFAULT_TYPE;
+
+    std::vector<Entry>          entries;
+
+    static int                  compare(const std::string& extension, const char* s, size_t length);
 };
 
 #endif
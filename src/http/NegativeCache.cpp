@@ -0,0 +1,119 @@
+#include "./NegativeCache.hpp"
+
+// Threads of one process share this one, share() swaps in a page workers share
+static volatile NegativeCache::Generation g_writes = 0;
+volatile NegativeCache::Generation* NegativeCache::writes = &g_writes;
+
+NegativeCache::Entry::Entry():
+  location(NULL),
+  expires(0),
+  writes(0) {}
+
+/*
+ * ==============================================
+ *                 Constructor
+ * ==============================================
+ */
+
+NegativeCache::NegativeCache(size_t max, time_t valid):
+  max(max),
+  valid(valid) {}
+
+/*
+ * ==============================================
+ *                 Destructor
+ * ==============================================
+ */
+
+NegativeCache::~NegativeCache() {}
+
+/*
+ * ==============================================
+ *                   Public
+ * ==============================================
+ */
+
+bool NegativeCache::isEnabled() const { return this->max > 0; }
+
+const NegativeCache::Entry* NegativeCache::find(const std::string& path, const LocationConfig& location) {
+  if (this->entries.empty())
+    return NULL;
+
+  expire(time(NULL));
+
+  EntryMap::iterator it = this->entries.find(path);
+  if (it == this->entries.end() || it->second.location != &location)
+    return NULL;
+  // Some loop wrote a file since, this may be it
+  if (it->second.writes != getWrites()) {
+    evict(it);
+    return NULL;
+  }
+  return &it->second;
+}
+
+const NegativeCache::Entry* NegativeCache::insert(const std::string& path, const LocationConfig& location,
+                                                  const SharedBuffer& body, Generation seen) {
+  if (this->max == 0)
+    return NULL;
+
+  time_t             now = time(NULL);
+  EntryMap::iterator it = this->entries.find(path);
+
+  if (it != this->entries.end())
+    evict(it);
+  expire(now);
+  if (this->entries.size() >= this->max)
+    evict(this->entries.find(this->ages.back()));
+
+  Entry entry;
+  entry.location = &location;
+  entry.body = body;
+  entry.expires = now + this->valid;
+  entry.writes = seen;
+  this->ages.push_front(path);
+  entry.age = this->ages.begin();
+  return &(this->entries[path] = entry);
+}
+
+void NegativeCache::invalidate(const std::string& path) {
+  EntryMap::iterator it = this->entries.find(path);
+
+  if (it != this->entries.end())
+    evict(it);
+  __sync_fetch_and_add(writes, 1);
+}
+
+void NegativeCache::share() {
+  void* page = mmap(NULL, sizeof(Generation), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+  if (page == MAP_FAILED)
+    throw std::runtime_error("negative_cache shared counter mmap failed");
+  writes = static_cast<volatile Generation*>(page);
+  *writes = g_writes;
+}
+
+NegativeCache::Generation NegativeCache::getWrites() {
+  return *writes;
+}
+
+/*
+ * ==============================================
+ *                   Private
+ * ==============================================
+ */
+
+void NegativeCache::evict(EntryMap::iterator it) {
+  this->ages.erase(it->second.age);
+  this->entries.erase(it);
+}
+
+void NegativeCache::expire(time_t now) {
+  while (!this->ages.empty()) {
+    EntryMap::iterator it = this->entries.find(this->ages.back());
+
+    if (it->second.expires > now)
+      break;
+    evict(it);
+  }
+}
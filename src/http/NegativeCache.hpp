@@ -0,0 +1,77 @@
+#ifndef NEGATIVE_CACHE_HPP
+# define NEGATIVE_CACHE_HPP
+
+# include "../config/LocationConfig.hpp"
+# include "../etc/SharedBuffer.hpp"
+
+# include <list>
+# include <map>
+# include <stdexcept>
+# include <string>
+# include <time.h>
+# include <sys/mman.h>
+
+/*
+ * Target paths recently found missing, each with the 404 body of the
+ * location that missed it. A repeated miss is answered from here with no
+ * stat and no error page read. Entries are trusted for `valid` seconds,
+ * the oldest goes first beyond `max` entries. Each event loop owns one,
+ * nothing here is locked.
+ *
+ * A PUT or POST in any loop of any worker counts a write on a counter
+ * every loop shares. An entry remembers the count from before its stat,
+ * and is dropped once another write has been counted since, so a file
+ * created anywhere is seen by the next request everywhere.
+ */
+class NegativeCache {
+  public:
+    typedef unsigned long       Generation;
+
+    struct Entry {
+      // The 404 body depends on the location's error_page
+      const LocationConfig*     location;
+      SharedBuffer              body;
+      time_t                    expires;
+      // Writes counted before the path was stat'ed
+      Generation                writes;
+      std::list<std::string>::iterator age;
+
+      Entry();
+    };
+
+    // max 0 turns the cache off
+    NegativeCache(size_t max, time_t valid);
+    ~NegativeCache();
+
+    bool                        isEnabled() const;
+    // NULL unless path is known missing for location
+    const Entry*                find(const std::string& path, const LocationConfig& location);
+    // NULL when the cache is off, seen is getWrites() from before path was stat'ed
+    const Entry*                insert(const std::string& path, const LocationConfig& location, const SharedBuffer& body,
+                                       Generation seen);
+    // After the server itself created path, counts a write for every loop
+    void                        invalidate(const std::string& path);
+
+    // Moves the write counter to shared memory, before the workers are forked
+    static void                 share();
+    static Generation           getWrites();
+
+  private:
+    typedef std::map<std::string, Entry> EntryMap;
+
+    static volatile Generation* writes;
+
+    size_t                      max;
+    time_t                      valid;
+    EntryMap                    entries;
+    // Newest first, which is also the order they expire in
+    std::list<std::string>      ages;
+
+    void                        evict(EntryMap::iterator it);
+    void                        expire(time_t now);
+
+    NegativeCache(const NegativeCache& obj);
+    NegativeCache&              operator=(const NegativeCache& obj);
+};
+
+#endif
@@ -0,0 +1,173 @@
+#include "./OpenFileCache.hpp"
+
+OpenFileCache::File::File():
+  fd(-1),
+  mode(0),
+  size(0),
+  mtime(0),
+  dev(0),
+  ino(0),
+  ctime(0),
+  validated(0),
+  accessed(0) {}
+
+/*
+ * ==============================================
+ *                 Constructor
+ * ==============================================
+ */
+
+OpenFileCache::OpenFileCache(size_t max, time_t inactive, time_t valid, const MimeType& types):
+  max(max),
+  inactive(inactive),
+  valid(valid),
+  types(types) {}
+
+/*
+ * ==============================================
+ *                 Destructor
+ * ==============================================
+ */
+
+OpenFileCache::~OpenFileCache() {
+  for (FileMap::iterator it = this->files.begin(); it != this->files.end(); ++it) {
+    if (it->second.fd != -1)
+      close(it->second.fd);
+  }
+  if (this->scratch.fd != -1)
+    close(this->scratch.fd);
+}
+
+/*
+ * ==============================================
+ *                   Public
+ * ==============================================
+ */
+
+const OpenFileCache::File* OpenFileCache::find(const std::string& path) {
+  struct stat st;
+  time_t      now = time(NULL);
+
+  if (this->max == 0) {
+    if (this->scratch.fd != -1)
+      close(this->scratch.fd);
+    this->scratch = File();
+    this->scratch.path = path;
+    if (stat(path.c_str(), &st) == -1)
+      return NULL;
+    load(this->scratch, st);
+    return &this->scratch;
+  }
+
+  expire(now);
+
+  FileMap::iterator it = this->files.find(path);
+  if (it != this->files.end()) {
+    File& file = it->second;
+
+    if (now - file.validated >= this->valid) {
+      if (stat(path.c_str(), &st) == -1) {
+        int err = errno;
+        evict(it);
+        errno = err;
+        return NULL;
+      }
+      if (isChanged(file, st)) {
+        if (file.fd != -1)
+          close(file.fd);
+        file.fd = -1;
+        load(file, st);
+      }
+      file.validated = now;
+    }
+    file.accessed = now;
+    this->lru.splice(this->lru.begin(), this->lru, file.lru);
+    return &file;
+  }
+
+  File file;
+  file.path = path;
+  if (stat(path.c_str(), &st) == -1)
+    return NULL;
+  load(file, st);
+  if (this->files.size() >= this->max)
+    evict(this->files.find(this->lru.back()));
+
+  file.validated = now;
+  file.accessed = now;
+  this->lru.push_front(path);
+  file.lru = this->lru.begin();
+  return &(this->files[path] = file);
+}
+
+int OpenFileCache::take(const File* file) {
+  // Entries are handed out const, but they are this cache's own
+  File& entry = const_cast<File&>(*file);
+
+  if (!S_ISREG(entry.mode))
+    return -1;
+  if (entry.fd == -1)
+    entry.fd = open(entry.path.c_str(), O_RDONLY | O_NONBLOCK);
+  if (entry.fd == -1 || &entry == &this->scratch) {
+    int fd = entry.fd;
+    entry.fd = -1;
+    return fd;
+  }
+  // Shares the cached open file, sendfile/pread never move its offset
+  return dup(entry.fd);
+}
+
+const std::string& OpenFileCache::getType(const std::string& path) const {
+  return this->types.getMimeType(path);
+}
+
+void OpenFileCache::invalidate(const std::string& path) {
+  FileMap::iterator it = this->files.find(path);
+
+  if (it != this->files.end())
+    evict(it);
+}
+
+/*
+ * ==============================================
+ *                   Private
+ * ==============================================
+ */
+
+void OpenFileCache::load(File& file, const struct stat& st) {
+  char etag[64];
+
+  snprintf(etag, sizeof(etag), "\"%lx-%llx-%llx\"", static_cast<unsigned long>(st.st_ino),
+    static_cast<unsigned long long>(st.st_size), static_cast<unsigned long long>(st.st_mtime));
+  file.mode = st.st_mode;
+  file.size = st.st_size;
+  file.mtime = st.st_mtime;
+  file.type = this->types.getMimeType(file.path);
+  file.dev = st.st_dev;
+  file.ino = st.st_ino;
+  file.ctime = st.st_ctime;
+  file.etag = etag;
+  file.lastModified = util::toHttpDate(st.st_mtime);
+}
+
+bool OpenFileCache::isChanged(const File& file, const struct stat& st) const {
+  return file.dev != st.st_dev || file.ino != st.st_ino || file.size != st.st_size
+    || file.mtime != st.st_mtime || file.ctime != st.st_ctime;
+}
+
+void OpenFileCache::evict(FileMap::iterator it) {
+  if (it->second.fd != -1)
+    close(it->second.fd);
+  this->lru.erase(it->second.lru);
+  this->files.erase(it);
+}
+
+void OpenFileCache::expire(time_t now) {
+  while (!this->lru.empty()) {
+    FileMap::iterator it = this->files.find(this->lru.back());
+
+    if (now - it->second.accessed < this->inactive)
+      break;
+    evict(it);
+  }
+}
@@ -0,0 +1,84 @@
+#ifndef OPEN_FILE_CACHE_HPP
+# define OPEN_FILE_CACHE_HPP
+
+# include "./MimeType.hpp"
+# include "../etc/Util.hpp"
+
+# include <list>
+# include <map>
+# include <string>
+# include <cstdio>
+# include <errno.h>
+# include <fcntl.h>
+# include <time.h>
+# include <unistd.h>
+# include <sys/stat.h>
+
+/*
+ * Keeps the fds and stat results of recently served paths, so a hot file
+ * costs one dup() instead of stat + open. A file is opened on its first
+ * take(), requests answered from the metadata never open it. Entries are
+ * checked against the disk again every `valid` seconds, dropped after
+ * `inactive` seconds unused, and the least recently used goes first
+ * beyond `max` entries. Each event loop owns one, nothing here is locked.
+ */
+class OpenFileCache {
+  public:
+    struct File {
+      std::string               path;
+      // -1 until a regular file is first taken
+      int                       fd;
+      mode_t                    mode;
+      off_t                     size;
+      time_t                    mtime;
+      std::string               type;
+      // Strong, from inode, size and mtime
+      std::string               etag;
+      std::string               lastModified;
+
+      dev_t                     dev;
+      ino_t                     ino;
+      time_t                    ctime;
+      time_t                    validated;
+      time_t                    accessed;
+      std::list<std::string>::iterator lru;
+
+      File();
+    };
+
+    // max 0 turns caching off, every find() goes to the disk
+    OpenFileCache(size_t max, time_t inactive, time_t valid, const MimeType& types);
+    ~OpenFileCache();
+
+    // NULL with errno set when the path can't be stat'ed
+    const File*                 find(const std::string& path);
+    // An fd of file the caller owns and closes, -1 when it can't be opened
+    int                         take(const File* file);
+    // Content type by the name alone, for a variant served in place of path
+    const std::string&          getType(const std::string& path) const;
+    // After the server itself changed or removed path
+    void                        invalidate(const std::string& path);
+
+  private:
+    typedef std::map<std::string, File> FileMap;
+
+    size_t                      max;
+    time_t                      inactive;
+    time_t                      valid;
+    FileMap                     files;
+    // Most recently used first
+    std::list<std::string>      lru;
+    File                        scratch;
+    // The config's table, which outlives the cache
+    const MimeType&             types;
+
+    void                        load(File& file, const struct stat& st);
+    bool                        isChanged(const File& file, const struct stat& st) const;
+    void                        evict(FileMap::iterator it);
+    void                        expire(time_t now);
+
+    OpenFileCache(const OpenFileCache& obj);
+    OpenFileCache&              operator=(const OpenFileCache& obj);
+};
+
+#endif
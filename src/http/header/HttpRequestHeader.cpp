@@ -6,6 +6,19 @@ const std::string HttpRequestHeader::CONNECTION = "Connection";
 const std::string HttpRequestHeader::CONTENT_TYPE = "Content-Type";
 const std::string HttpRequestHeader::CONTENT_LENGTH = "Content-Length";
 const std::string HttpRequestHeader::COOKIE = "Cookie";
+const std::string HttpRequestHeader::IF_NONE_MATCH = "If-None-Match";
+const std::string HttpRequestHeader::IF_MODIFIED_SINCE = "If-Modified-Since";
+const std::string HttpRequestHeader::RANGE = "Range";
+const std::string HttpRequestHeader::IF_RANGE = "If-Range";
+const std::string HttpRequestHeader::ACCEPT_ENCODING = "Accept-Encoding";
+
+// Decided on before the body, or trusted by the session and the CGI
+const char* HttpRequestHeader::FORBIDDEN_TRAILERS[] = {
+  "host", "content-length", "transfer-encoding", "trailer", "te", "connection", "keep-alive",
+  "upgrade", "expect", "max-forwards", "content-type", "content-encoding", "content-range",
+  "range", "if-range", "if-match", "if-none-match", "if-modified-since", "if-unmodified-since",
+  "cache-control", "authorization", "proxy-authorization", "cookie", NULL
+};
 
 HttpRequestHeader::HttpRequestHeader():
   conn(KEEP_ALIVE),
@@ -25,15 +38,11 @@ HttpRequestHeader& HttpRequestHeader::operator=(const HttpRequestHeader& obj) {
   return *this;
 }
 
-void HttpRequestHeader::parse(const std::string& reqHeader) {
-  std::vector<std::string>            vs;
-  std::vector<std::string>::iterator  it;
+void HttpRequestHeader::parse(const std::string& buf, const std::vector<HttpParser::Field>& fields) {
+  std::vector<HttpParser::Field>::const_iterator it;
 
-  vs = util::split(reqHeader, CRLF);
-  for (it = vs.begin(); it != vs.end(); ++it) {
-    std::pair<std::string, std::string> p = splitField(*it);
-    this->header.set(p.first, p.second);
-  }
+  for (it = fields.begin(); it != fields.end(); ++it)
+    this->header.set(HttpParser::str(buf, it->first), HttpParser::str(buf, it->second));
   parseConnection();
   parseTransferEncoding();
 }
@@ -54,18 +63,6 @@ void HttpRequestHeader::parseTransferEncoding() {
     setTransferEncoding(CHUNKED);
 }
 
-std::pair<std::string, std::string> HttpRequestHeader::splitField(std::string line) {
-  std::string field;
-  std::string value;
-  size_t pos;
-
-  if ((pos = line.find(":")) == std::string::npos) throw BAD_REQUEST;
-  field = util::trimSpace(line.substr(0, pos));
-  value = util::trimSpace(line.substr(pos + 1));
-
-  return std::make_pair(field, value);
-}
-
 // getter
 
 std::string HttpRequestHeader::get(std::string key) const {
@@ -100,6 +97,18 @@ void  HttpRequestHeader::setConnection(HttpRequestHeader::connection conn) {
   this->conn = conn;
 }
 
+void HttpRequestHeader::addTrailers(const std::vector<std::pair<std::string, std::string> >& trailers) {
+  for (size_t i = 0; i < trailers.size(); ++i) {
+    std::string name = util::toLowerStr(trailers[i].first);
+    size_t      k = 0;
+
+    while (FORBIDDEN_TRAILERS[k] != NULL && name != FORBIDDEN_TRAILERS[k])
+      ++k;
+    if (FORBIDDEN_TRAILERS[k] == NULL)
+      this->header.set(name, trailers[i].second);
+  }
+}
+
 void HttpRequestHeader::setTransferEncoding(HttpRequestHeader::transfer_encoding te) {
   this->te = te;
 }
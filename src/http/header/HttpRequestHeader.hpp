@@ -4,6 +4,7 @@
 # include "./HttpHeader.hpp"
 # include "../../etc/Util.hpp"
 # include "../HttpStatus.hpp"
+# include "../HttpParser.hpp"
 
 # include <string>
 # include <map>
@@ -16,6 +17,11 @@ class HttpRequestHeader {
     static const std::string  CONTENT_TYPE;
     static const std::string  CONTENT_LENGTH;
     static const std::string  COOKIE;
+    static const std::string  IF_NONE_MATCH;
+    static const std::string  IF_MODIFIED_SINCE;
+    static const std::string  RANGE;
+    static const std::string  IF_RANGE;
+    static const std::string  ACCEPT_ENCODING;
 
     HttpRequestHeader();
     ~HttpRequestHeader();
@@ -31,7 +37,7 @@ class HttpRequestHeader {
       CHUNKED
     };
 
-    void parse(const std::string& reqHeader);
+    void parse(const std::string& buf, const std::vector<HttpParser::Field>& fields);
 
     std::string                               get(std::string key) const;
     connection                                getConnection() const;
@@ -39,8 +45,13 @@ class HttpRequestHeader {
     const std::map<std::string, std::string>  getCustomeHeader() const;
 
     void                                      setConnection(connection conn);
+    // Trailer fields of a chunked body, never override the header. Fields
+    // that frame, route, authenticate or describe the body are dropped.
+    void                                      addTrailers(const std::vector<std::pair<std::string, std::string> >& trailers);
 
   private:
+    static const char*                  FORBIDDEN_TRAILERS[];
+
     HttpHeader                          header;
     connection                          conn;
     transfer_encoding                   te;
@@ -49,8 +60,6 @@ class HttpRequestHeader {
     void                                parseTransferEncoding();
 
     void                                setTransferEncoding(transfer_encoding te);
-
-    std::pair<std::string, std::string> splitField(std::string line);
 };
 
 #endif
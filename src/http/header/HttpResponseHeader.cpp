@@ -10,6 +10,13 @@ const std::string HttpResponseHeader::SERVER = "server";
 const std::string HttpResponseHeader::CONNECTION = "connection";
 const std::string HttpResponseHeader::UPGRADE = "upgrade";
 const std::string HttpResponseHeader::SET_COOKIE = "set-cookie";
+const std::string HttpResponseHeader::ETAG = "etag";
+const std::string HttpResponseHeader::LAST_MODIFIED = "last-modified";
+const std::string HttpResponseHeader::ACCEPT_RANGES = "accept-ranges";
+const std::string HttpResponseHeader::CONTENT_RANGE = "content-range";
+const std::string HttpResponseHeader::CONTENT_ENCODING = "content-encoding";
+const std::string HttpResponseHeader::VARY = "vary";
+const std::string HttpResponseHeader::TRANSFER_ENCODING = "transfer-encoding";
 
 HttpResponseHeader::HttpResponseHeader() {}
 
@@ -19,6 +19,13 @@ class HttpResponseHeader {
     static const std::string CONNECTION;
     static const std::string UPGRADE;
     static const std::string SET_COOKIE;
+    static const std::string ETAG;
+    static const std::string LAST_MODIFIED;
+    static const std::string ACCEPT_RANGES;
+    static const std::string CONTENT_RANGE;
+    static const std::string CONTENT_ENCODING;
+    static const std::string VARY;
+    static const std::string TRANSFER_ENCODING;
 
     HttpResponseHeader();
     HttpResponseHeader(const HttpResponseHeader& obj);
@@ -17,13 +17,20 @@ int main(int argc, char **argv) {
   }
   logger::info << "The config file is set to [" << config_file << "]" << logger::endl;
 
+  // A peer closing early must fail the write, not kill the process
+  signal(SIGPIPE, SIG_IGN);
+
   try {
     ConfigParser parser;
     Config conf = parser.parse(config_file);
     logger::info << "Config parsing ok" << logger::endl;
 
-    Server server(conf);
-    server.run();
+    if (conf.getWorkerProcesses() > 1) {
+      Master master(conf);
+      master.run();
+    }
+    else
+      Master::work(conf);
   } catch (std::exception &e) {
     logger::error << e.what() << logger::endl;
     return EXIT_FAILURE;
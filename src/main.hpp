@@ -3,6 +3,7 @@
 
 # include "./etc/Logger.hpp"
 # include "./network/Server.hpp"
+# include "./network/Master.hpp"
 # include "./config/parser/ConfigParser.hpp"
 # include "./config/Config.hpp"
 
@@ -0,0 +1,171 @@
+#include "./Acceptor.hpp"
+
+/*
+ * ==============================================
+ *                 Constructor
+ * ==============================================
+ */
+
+Acceptor::Acceptor(Config& config):
+  config(config),
+  sessionManager(),
+  poller(Poller::create(config.getHttpConfig().getIoEngine())),
+  next(0) {
+}
+
+/*
+ * ==============================================
+ *                 Destructor
+ * ==============================================
+ */
+
+Acceptor::~Acceptor() {
+  for (size_t i = 0; i < this->reactors.size(); ++i)
+    this->reactors[i]->stop();
+  for (size_t i = 0; i < this->threads.size(); ++i)
+    pthread_join(this->threads[i], NULL);
+  for (size_t i = 0; i < this->reactors.size(); ++i)
+    delete this->reactors[i];
+  for (size_t i = 0; i < this->queues.size(); ++i)
+    delete this->queues[i];
+
+  for (size_t i = 0; i < this->listens_fd.size(); ++i) {
+    if (close(this->listens_fd[i]) == -1)
+      logger::warning << "Closed, server(" << i << ") with -1" << logger::endl;
+    else
+      logger::info << "Closed, server(" << i << ")" << logger::endl;
+  }
+
+  delete this->poller;
+}
+
+/*
+ * ==============================================
+ *                   Public
+ * ==============================================
+ */
+
+void Acceptor::run() {
+  setup();
+  spawn();
+  logger::info << "Acceptor setup done, " << this->reactors.size() << " reactors, io engine: " << this->poller->getEngine() << logger::endl;
+  loop();
+}
+
+/*
+ * ==============================================
+ *                 Acceptor core
+ * ==============================================
+ */
+
+void Acceptor::setup() {
+  // One listener per address, the servers sharing it are told apart by Host
+  const std::vector<std::pair<std::string, short> >& listens = this->config.getHttpConfig().getListens();
+  for (std::vector<std::pair<std::string, short> >::const_iterator it = listens.begin(); it != listens.end(); ++it) {
+    int fd = Listener::open(it->first, it->second, this->config.getWorkerProcesses() > 1);
+
+    this->listens_fd.push_back(fd);
+    this->poller->add(fd, Poller::READ);
+  }
+}
+
+void Acceptor::spawn() {
+  for (int i = 0; i < this->config.getWorkerThreads(); ++i) {
+    FdQueue* queue = new FdQueue();
+    this->queues.push_back(queue);
+    this->reactors.push_back(new Server(this->config, this->sessionManager, *queue));
+  }
+
+  for (size_t i = 0; i < this->reactors.size(); ++i) {
+    pthread_t tid;
+
+    if (pthread_create(&tid, NULL, routine, this->reactors[i]))
+      throw std::runtime_error("create reactor thread error");
+    this->threads.push_back(tid);
+  }
+}
+
+void Acceptor::loop() {
+  while (1) {
+    int ready = this->poller->wait(-1);
+
+    if (ready == -1) {
+      logger::error << "Poller returns -1, break" << logger::endl;
+      break;
+    }
+
+    for (int i = 0; i < ready; ++i) {
+      if (this->poller->getReadyEvents(i) & Poller::READ)
+        acceptConnect(this->poller->getReadyFd(i));
+    }
+  }
+}
+
+void Acceptor::acceptConnect(int server_fd) {
+  struct sockaddr_in  client_addr;
+  socklen_t           size;
+
+  size = sizeof(client_addr);
+  int client_fd = accept(server_fd, (struct sockaddr *)&client_addr, &size);
+  if (client_fd == -1) {
+    logger::warning << "accept failed" << logger::endl;
+    return;
+  }
+
+  logger::info << "Accept, client(" << client_fd << ", " << inet_ntoa(client_addr.sin_addr) << ":" << ntohs(client_addr.sin_port) << ") into (" << server_fd << ")" << logger::endl;
+  if (!dispatch(client_fd)) {
+    close(client_fd);
+    // The Master forks a new worker, a single process just ends
+    if (isDown())
+      throw std::runtime_error("all reactors stopped");
+    logger::warning << "All reactors are full, client(" << client_fd << ") dropped" << logger::endl;
+    return;
+  }
+}
+
+// Round robin over the reactors still running
+bool Acceptor::dispatch(int client_fd) {
+  for (size_t i = 0; i < this->queues.size(); ++i) {
+    FdQueue* queue = this->queues[this->next];
+
+    this->next = (this->next + 1) % this->queues.size();
+    if (queue->isAbandoned()) {
+      reclaim(queue);
+      continue;
+    }
+    if (queue->push(client_fd)) {
+      queue->notify();
+      return true;
+    }
+  }
+  return false;
+}
+
+// Clients pushed before the reactor stopped are closed, not left hanging
+void Acceptor::reclaim(FdQueue* queue) {
+  int fd;
+
+  while (queue->pop(fd)) {
+    close(fd);
+    logger::warning << "Reactor stopped, client(" << fd << ") dropped" << logger::endl;
+  }
+}
+
+bool Acceptor::isDown() const {
+  for (size_t i = 0; i < this->queues.size(); ++i) {
+    if (!this->queues[i]->isAbandoned())
+      return false;
+  }
+  return true;
+}
+
+void* Acceptor::routine(void* p) {
+  Server* server = reinterpret_cast<Server*>(p);
+
+  try {
+    server->run();
+  } catch (std::exception& e) {
+    logger::error << "reactor: " << e.what() << logger::endl;
+  }
+  return NULL;
+}
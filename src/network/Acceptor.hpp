@@ -0,0 +1,56 @@
+#ifndef ACCEPTOR_HPP
+# define ACCEPTOR_HPP
+
+# include "./FdQueue.hpp"
+# include "./Listener.hpp"
+# include "./Poller.hpp"
+# include "./Server.hpp"
+# include "./SessionManager.hpp"
+# include "../config/Config.hpp"
+# include "../etc/Logger.hpp"
+
+# include <arpa/inet.h>
+# include <pthread.h>
+# include <unistd.h>
+# include <vector>
+# include <set>
+
+/*
+ * Threaded mode: accepts on the listeners and hands the clients round robin
+ * to worker_threads reactors. Every reactor is a Server with its own poller
+ * and connection state, only the SessionManager is shared. A reactor that
+ * stops leaves the rotation, the worker ends once none is left.
+ */
+class Acceptor {
+  public:
+    Acceptor(Config& config);
+    ~Acceptor();
+
+    void                  run();
+
+  private:
+    Config&               config;
+    SessionManager        sessionManager;
+    Poller*               poller;
+
+    std::vector<int>      listens_fd;
+    std::vector<FdQueue*> queues;
+    std::vector<Server*>  reactors;
+    std::vector<pthread_t> threads;
+    size_t                next;
+
+    void                  setup();
+    void                  spawn();
+    void                  loop();
+    void                  acceptConnect(int server_fd);
+    bool                  dispatch(int client_fd);
+    void                  reclaim(FdQueue* queue);
+    bool                  isDown() const;
+
+    static void*          routine(void* p);
+
+    Acceptor(const Acceptor& obj);
+    Acceptor&             operator=(const Acceptor& obj);
+};
+
+#endif
@@ -1,29 +1,97 @@
 #include "./Connection.hpp"
 
+const int Connection::PAGE_SHIFT = 6;
+const int Connection::PAGE_SIZE = 1 << Connection::PAGE_SHIFT;
+
+Connection::Slot::Slot(): kind(FREE), owner(-1), requests(-1), listen(-1) {}
+
 Connection::Connection(const Config& config):
   client_header_timeout(config.getHttpConfig().getClientHeaderTimeout()),
   client_body_timeout(config.getHttpConfig().getClientBodyTimeout()),
   send_timeout(config.getHttpConfig().getSendTimeout()) {
 }
 
-Connection::~Connection() {}
+Connection::~Connection() {
+  for (size_t i = 0; i < this->pages.size(); ++i)
+    delete[] this->pages[i];
+}
 
-std::set<int> Connection::getTimeoutList() {
-  std::set<int> timeout_fd_list;
+void Connection::attach(int fd, Kind kind, int owner) {
+  size_t page = fd >> PAGE_SHIFT;
+
+  if (page >= this->pages.size())
+    this->pages.resize(page + 1, NULL);
+  if (this->pages[page] == NULL)
+    this->pages[page] = new Slot[PAGE_SIZE];
+
+  Slot& slot = this->pages[page][fd & (PAGE_SIZE - 1)];
+  this->wheel.cancel(slot.timer);
+  slot.kind = kind;
+  slot.owner = owner;
+  slot.requests = -1;
+  slot.listen = -1;
+  slot.timer.fd = fd;
+}
 
-  for (std::map<int, time_t>::iterator it = this->table.begin(); it != this->table.end(); ++it) {
-    if (time(NULL) > it->second) {
-      timeout_fd_list.insert(it->first);
-    }
-  }
+void Connection::release(int fd) {
+  Slot* slot = find(fd);
+
+  if (slot == NULL || slot->kind == FREE)
+    return;
+  if (slot->kind == CLIENT)
+    reset(fd);
+  this->wheel.cancel(slot->timer);
+  slot->kind = FREE;
+  slot->owner = -1;
+  slot->requests = -1;
+}
+
+void Connection::reset(int fd) {
+  Slot& slot = at(fd);
+
+  slot.request.discardBodyFile();
+  slot.request = HttpRequest();
+  slot.response = HttpResponse();
+  slot.recv.clear();
+  slot.parser.reset();
+  slot.chunked.reset(0);
+}
+
+Connection::Kind Connection::kindOf(int fd) const {
+  Slot* slot = find(fd);
+
+  if (slot == NULL)
+    return FREE;
+  return slot->kind;
+}
+
+Connection::Slot& Connection::at(int fd) {
+  return this->pages[fd >> PAGE_SHIFT][fd & (PAGE_SIZE - 1)];
+}
+
+Connection::Slot* Connection::find(int fd) const {
+  size_t page = fd >> PAGE_SHIFT;
+
+  if (fd < 0 || page >= this->pages.size() || this->pages[page] == NULL)
+    return NULL;
+  return &this->pages[page][fd & (PAGE_SIZE - 1)];
+}
+
+std::vector<int> Connection::getTimeoutList() {
+  std::vector<int> timeout_fd_list;
+
+  this->wheel.expire(TimerWheel::now(), timeout_fd_list);
 
   return timeout_fd_list;
 }
 
+int Connection::getNextTimeout() const {
+  return this->wheel.nextTimeout(TimerWheel::now());
+}
+
 void Connection::update(int fd, enum WHAT timeout) {
   int to = 60;
 
-  this->table.erase(fd);
   if (timeout == HEADER)
     to = this->client_header_timeout;
   else if (timeout == BODY)
@@ -31,47 +99,39 @@ void Connection::update(int fd, enum WHAT timeout) {
   else if (timeout == SEND)
     to = this->send_timeout;
 
-  this->table.insert(std::make_pair(fd, time(NULL) + to));
+  arm(fd, to);
 }
 
 void Connection::updateKeepAlive(int fd, const ServerConfig& conf) {
-  if (this->table.find(fd) != this->table.end()) {
-    this->table.erase(fd);
-  }
-
-  this->table.insert(std::make_pair(fd, time(NULL) + conf.getKeepAliveTimeout()));
+  arm(fd, conf.getKeepAliveTimeout());
 }
 
 void Connection::updateGateway(int fd, const ServerConfig& conf) {
-  if (this->table.find(fd) != this->table.end()) {
-    this->table.erase(fd);
-  }
-
-  this->table.insert(std::make_pair(fd, time(NULL) + conf.getGatewayTimeout()));
+  arm(fd, conf.getGatewayTimeout());
 }
 
 int Connection::updateRequests(int fd, const ServerConfig& conf) {
-  int config_max = conf.getKeepAliveRequests();
-  int reqs;
+  Slot& slot = at(fd);
+  int   config_max = conf.getKeepAliveRequests();
+  int   reqs;
 
-  if (this->req_table.find(fd) != this->req_table.end()) {
-    reqs = this->req_table[fd] - 1;
+  if (slot.requests != -1) {
+    reqs = slot.requests - 1;
     if (config_max < reqs)
       reqs = config_max;
-    this->req_table.erase(fd);
   }
   else
-    reqs = conf.getKeepAliveRequests();
+    reqs = config_max;
 
-  this->req_table.insert(std::make_pair(fd, reqs));
+  slot.requests = reqs;
 
   return reqs;
 }
 
 void Connection::remove(int fd) {
-  this->table.erase(fd);
+  this->wheel.cancel(at(fd).timer);
 }
 
-void Connection::removeRequests(int fd) {
-  this->req_table.erase(fd);
+void Connection::arm(int fd, unsigned int sec) {
+  this->wheel.arm(at(fd).timer, TimerWheel::now() + static_cast<TimerWheel::msec_t>(sec) * 1000);
 }
@@ -1,26 +1,73 @@
 #ifndef CONNECTION_HPP
 # define CONNECTION_HPP
 
+# include "./TimerWheel.hpp"
 # include "../config/Config.hpp"
+# include "../http/ChunkedDecoder.hpp"
+# include "../http/HttpRequest.hpp"
+# include "../http/HttpResponse.hpp"
 
 # include <string>
-# include <set>
-# include <map>
 # include <vector>
 # include <time.h>
 
+/*
+ * Per-fd state of a Server loop, indexed directly by fd.
+ * Every fd the loop polls owns a slot: clients carry the request/response
+ * pair, file and CGI fds point back to their client with owner.
+ * Slots live in fixed pages that never move, so a Slot& stays valid while
+ * other fds are attached. The timeouts are armed on a timing wheel through
+ * the node embedded in each client slot.
+ */
 class Connection {
   public:
-    Connection(const Config& config);
-    ~Connection(void);
-
     enum WHAT {
       HEADER = 0,
       BODY,
       SEND
     };
 
-    std::set<int>             getTimeoutList();
+    enum Kind {
+      FREE = 0,
+      CLIENT,
+      FILE,
+      CGI,
+      LISTEN,
+      INBOX
+    };
+
+    struct Slot {
+      // Hot, read on every event
+      Kind                    kind;
+      int                     owner;
+      int                     requests;
+      // Listen address group the client came in through, for the Host lookup
+      int                     listen;
+      TimerWheel::Node        timer;
+
+      HttpRequest             request;
+      HttpResponse            response;
+      std::string             recv;
+      HttpParser              parser;
+      ChunkedDecoder          chunked;
+
+      Slot();
+    };
+
+    Connection(const Config& config);
+    ~Connection(void);
+
+    void                      attach(int fd, Kind kind, int owner);
+    void                      release(int fd);
+    // Fresh request/response for the next request of a keep-alive client
+    void                      reset(int fd);
+
+    Kind                      kindOf(int fd) const;
+    Slot&                     at(int fd);
+
+    std::vector<int>          getTimeoutList();
+    // Poller wait timeout until the next deadline, -1 without any
+    int                       getNextTimeout() const;
 
     void                      update(int fd, enum WHAT timeout);
     void                      updateKeepAlive(int fd, const ServerConfig& conf);
@@ -28,18 +75,23 @@ class Connection {
     int                       updateRequests(int fd, const ServerConfig& conf);
 
     void                      remove(int fd);
-    void                      removeRequests(int fd);
 
   private:
+    static const int          PAGE_SHIFT;
+    static const int          PAGE_SIZE;
+
     const unsigned int        client_header_timeout;
     const unsigned int        client_body_timeout;
     const unsigned int        send_timeout;
 
-    // fd, time(sec)
-    std::map<int, time_t>     table;
+    std::vector<Slot*>        pages;
+    TimerWheel                wheel;
+
+    void                      arm(int fd, unsigned int sec);
+    Slot*                     find(int fd) const;
 
-    // fd, requests
-    std::map<int, int>        req_table;
+    Connection(const Connection& obj);
+    Connection&               operator=(const Connection& obj);
 };
 
 #endif
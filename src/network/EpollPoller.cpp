@@ -0,0 +1,128 @@
+#include "./EpollPoller.hpp"
+
+#ifdef __linux__
+
+# include <stdexcept>
+
+const int EpollPoller::MAX_EVENTS = 1024;
+
+// Marks fds that epoll refused (regular files), not exposed by isSet()
+static const int UNPOLLABLE = 1 << 2;
+
+EpollPoller::EpollPoller():
+  Poller(),
+  epfd(epoll_create(MAX_EVENTS)),
+  events(MAX_EVENTS) {
+    if (this->epfd == -1)
+      throw std::runtime_error("epoll_create failed");
+}
+
+EpollPoller::~EpollPoller() {
+  close(this->epfd);
+}
+
+void EpollPoller::add(int fd, int events) {
+  if (fd < 0)
+    return;
+  growInterest(fd);
+
+  int prev = this->interest[fd];
+  if ((prev | events) != prev)
+    control(fd, prev, prev | events);
+}
+
+void EpollPoller::remove(int fd, int events) {
+  if (fd < 0 || static_cast<size_t>(fd) >= this->interest.size())
+    return;
+
+  int prev = this->interest[fd];
+  if ((prev & ~events) != prev)
+    control(fd, prev, prev & ~events);
+}
+
+int EpollPoller::wait(int timeout_ms) {
+  int n;
+
+  this->ready.clear();
+  if (!this->always.empty())
+    timeout_ms = 0;
+
+  n = epoll_wait(this->epfd, &this->events[0], this->events.size(), timeout_ms);
+  if (n == -1)
+    return errno == EINTR ? 0 : -1;
+
+  for (int i = 0; i < n; ++i) {
+    int fd = this->events[i].data.fd;
+    int ev = this->events[i].events;
+    int r = NONE;
+
+    if (ev & (EPOLLIN | EPOLLHUP | EPOLLERR))
+      r |= READ;
+    if (ev & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+      r |= WRITE;
+    r &= this->interest[fd];
+    if (r != NONE)
+      this->ready.push_back(std::make_pair(fd, r));
+  }
+  for (size_t i = 0; i < this->always.size(); ++i) {
+    int fd = this->always[i];
+    this->ready.push_back(std::make_pair(fd, this->interest[fd] & (READ | WRITE)));
+  }
+
+  if (static_cast<size_t>(n) == this->events.size())
+    this->events.resize(this->events.size() * 2);
+
+  return this->ready.size();
+}
+
+std::string EpollPoller::getEngine() const {
+  return EPOLL;
+}
+
+void EpollPoller::control(int fd, int prev, int next) {
+  struct epoll_event ev;
+
+  if (prev & UNPOLLABLE) {
+    if ((next & (READ | WRITE)) == 0) {
+      removeAlways(fd);
+      this->interest[fd] = NONE;
+    }
+    else
+      this->interest[fd] = next | UNPOLLABLE;
+    return;
+  }
+
+  ev.events = 0;
+  ev.data.fd = fd;
+  if (next & READ)
+    ev.events |= EPOLLIN;
+  if (next & WRITE)
+    ev.events |= EPOLLOUT;
+
+  if (prev == NONE && next != NONE) {
+    if (epoll_ctl(this->epfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+      if (errno != EPERM)
+        throw std::runtime_error("epoll_ctl add failed");
+      this->always.push_back(fd);
+      next |= UNPOLLABLE;
+    }
+  }
+  else if (prev != NONE && next != NONE)
+    epoll_ctl(this->epfd, EPOLL_CTL_MOD, fd, &ev);
+  else if (prev != NONE && next == NONE)
+    epoll_ctl(this->epfd, EPOLL_CTL_DEL, fd, &ev);
+
+  this->interest[fd] = next;
+}
+
+void EpollPoller::removeAlways(int fd) {
+  for (size_t i = 0; i < this->always.size(); ++i) {
+    if (this->always[i] == fd) {
+      this->always[i] = this->always.back();
+      this->always.pop_back();
+      return;
+    }
+  }
+}
+
+#endif
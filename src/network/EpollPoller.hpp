@@ -0,0 +1,36 @@
+#ifndef EPOLL_POLLER_HPP
+# define EPOLL_POLLER_HPP
+
+# ifdef __linux__
+
+#  include "./Poller.hpp"
+
+#  include <sys/epoll.h>
+#  include <errno.h>
+#  include <unistd.h>
+
+class EpollPoller: public Poller {
+  public:
+    EpollPoller();
+    ~EpollPoller();
+
+    void                              add(int fd, int events);
+    void                              remove(int fd, int events);
+    int                               wait(int timeout_ms);
+    std::string                       getEngine() const;
+
+  private:
+    static const int                  MAX_EVENTS;
+
+    int                               epfd;
+    std::vector<struct epoll_event>   events;
+    // Regular files can't be registered to epoll, they are always ready
+    std::vector<int>                  always;
+
+    void                              control(int fd, int prev, int next);
+    void                              removeAlways(int fd);
+};
+
+# endif
+
+#endif
@@ -0,0 +1,86 @@
+#include "./FdQueue.hpp"
+
+// Power of two, indices wrap with a mask
+const unsigned FdQueue::CAPACITY = 4096;
+
+FdQueue::FdQueue(): ring(new int[CAPACITY]), head(0), tail(0), abandoned(false) {
+  if (pipe(this->wake) == -1) {
+    delete[] this->ring;
+    throw std::runtime_error("FdQueue pipe failed");
+  }
+  if (fcntl(this->wake[0], F_SETFL, O_NONBLOCK) == -1 ||
+      fcntl(this->wake[1], F_SETFL, O_NONBLOCK) == -1) {
+    close(this->wake[0]);
+    close(this->wake[1]);
+    delete[] this->ring;
+    throw std::runtime_error("FdQueue fcntl failed");
+  }
+}
+
+FdQueue::~FdQueue() {
+  int fd;
+
+  // Clients that were never picked up
+  while (pop(fd))
+    close(fd);
+  close(this->wake[0]);
+  close(this->wake[1]);
+  delete[] this->ring;
+}
+
+bool FdQueue::push(int fd) {
+  unsigned tail = this->tail;
+
+  __sync_synchronize();
+  if (tail - this->head == CAPACITY)
+    return false;
+  this->ring[tail & (CAPACITY - 1)] = fd;
+  // The slot must be visible before the consumer sees the new tail
+  __sync_synchronize();
+  this->tail = tail + 1;
+  return true;
+}
+
+void FdQueue::notify() {
+  char c = 0;
+
+  // A full pipe already means a pending wake up
+  if (write(this->wake[1], &c, 1) == -1)
+    return;
+}
+
+bool FdQueue::pop(int& fd) {
+  unsigned head = this->head;
+
+  __sync_synchronize();
+  if (head == this->tail)
+    return false;
+  __sync_synchronize();
+  fd = this->ring[head & (CAPACITY - 1)];
+  // The slot is read before the producer may reuse it
+  __sync_synchronize();
+  this->head = head + 1;
+  return true;
+}
+
+void FdQueue::drain() {
+  char buf[64];
+
+  while (read(this->wake[0], buf, sizeof(buf)) > 0)
+    ;
+}
+
+int FdQueue::getReadFd() const {
+  return this->wake[0];
+}
+
+void FdQueue::abandon() {
+  __sync_synchronize();
+  this->abandoned = true;
+  __sync_synchronize();
+}
+
+bool FdQueue::isAbandoned() const {
+  __sync_synchronize();
+  return this->abandoned;
+}
@@ -0,0 +1,43 @@
+#ifndef FD_QUEUE_HPP
+# define FD_QUEUE_HPP
+
+# include <fcntl.h>
+# include <unistd.h>
+# include <stdexcept>
+
+/*
+ * Single producer, single consumer ring of fds handed from the acceptor
+ * to a reactor thread. push/pop only publish indices with barriers, so
+ * neither side ever takes a lock; the pipe just wakes the reactor's poller.
+ */
+class FdQueue {
+  public:
+    static const unsigned CAPACITY;
+
+    FdQueue();
+    ~FdQueue();
+
+    // Producer side, false when the ring is full
+    bool                  push(int fd);
+    void                  notify();
+
+    // Consumer side
+    bool                  pop(int& fd);
+    void                  drain();
+    int                   getReadFd() const;
+    // The consumer is gone, the producer takes over pop() to close the rest
+    void                  abandon();
+    bool                  isAbandoned() const;
+
+  private:
+    int*                  ring;
+    volatile unsigned     head;
+    volatile unsigned     tail;
+    volatile bool         abandoned;
+    int                   wake[2];
+
+    FdQueue(const FdQueue& obj);
+    FdQueue&              operator=(const FdQueue& obj);
+};
+
+#endif
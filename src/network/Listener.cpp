@@ -0,0 +1,85 @@
+#include "./Listener.hpp"
+
+const size_t  Listener::BIND_MAX_TRIES = 10;
+const size_t  Listener::LISTEN_MAX_TRIES = 10;
+const size_t  Listener::TRY_SLEEP_TIME = 5;
+const size_t  Listener::BACKLOG = 1024;
+
+int Listener::open(const std::string& host, int port, bool reuse_port) {
+  sockaddr_in sock;
+  int         fd;
+
+  fd = init_socket(reuse_port);
+  try {
+    init_sockaddr_in(host, port, sock);
+    open_socket(fd, sock);
+  } catch (std::exception& e) {
+    close(fd);
+    throw;
+  }
+  return fd;
+}
+
+int Listener::init_socket(bool reuse_port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd == -1)
+    throw std::runtime_error("Server initialization failed");
+
+//  int option = 1;
+//  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+
+  // Every worker binds its own listener, the kernel balances accepts
+  if (reuse_port) {
+    int option = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option)) == -1) {
+      close(fd);
+      throw std::runtime_error("Server SO_REUSEPORT failed");
+    }
+  }
+
+  return fd;
+}
+
+void Listener::init_sockaddr_in(const std::string& host, int port, sockaddr_in& in) {
+  if (!memset(&in, 0, sizeof(in)))
+    throw std::runtime_error("Server initialization failed");
+
+  in.sin_family = AF_INET;
+  inet_pton(AF_INET, host.c_str(), &(in.sin_addr));
+  in.sin_port = htons(port);
+
+  logger::info << "Preparing... Host=[" << inet_ntoa(in.sin_addr) << "] Port=[" << ntohs(in.sin_port) << "]" << logger::endl;
+}
+
+void Listener::open_socket(int server_fd, sockaddr_in& in) {
+  bool  bind_success = false;
+  bool  listen_success = false;
+
+  for (size_t i = 0; i < BIND_MAX_TRIES; ++i) {
+    if (bind(server_fd, (struct sockaddr*)&in, sizeof(in)) == -1)
+      logger::warning << "Bind failed... retry... " << i + 1 << logger::endl;
+    else {
+      bind_success = true;
+      break;
+    }
+    sleep(TRY_SLEEP_TIME);
+  }
+
+  if (bind_success == false)
+    throw std::runtime_error("Server bind failed");
+
+  for (size_t i = 0; i < LISTEN_MAX_TRIES; ++i) {
+    if (listen(server_fd, BACKLOG) == -1)
+      logger::warning << "Listen failed... retry... " << i + 1 << logger::endl;
+    else {
+      listen_success = true;
+      break;
+    }
+    sleep(TRY_SLEEP_TIME);
+  }
+
+  if (listen_success == false)
+    throw std::runtime_error("Server listen failed");
+
+  logger::info << "Listening... (" << server_fd << ") \n\n\"http://" << inet_ntoa(in.sin_addr) << ":" << ntohs(in.sin_port) << "\"\n" << logger::endl;
+}
@@ -0,0 +1,35 @@
+#ifndef LISTENER_HPP
+# define LISTENER_HPP
+
+# include "../etc/Logger.hpp"
+
+# include <arpa/inet.h>
+# include <string.h>
+# include <unistd.h>
+# include <stdexcept>
+# include <string>
+# include <sys/socket.h>
+
+/*
+ * Opens the listening sockets, shared by the Server and the Acceptor.
+ */
+class Listener {
+  public:
+    static const size_t BACKLOG;
+
+    // Throws std::runtime_error when the socket can't be bound or listened
+    static int          open(const std::string& host, int port, bool reuse_port);
+
+  private:
+    static const size_t BIND_MAX_TRIES;
+    static const size_t LISTEN_MAX_TRIES;
+    static const size_t TRY_SLEEP_TIME;
+
+    static int          init_socket(bool reuse_port);
+    static void         init_sockaddr_in(const std::string& host, int port, sockaddr_in& in);
+    static void         open_socket(int server_fd, sockaddr_in& in);
+
+    Listener();
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include "./LoadMeter.hpp"
+
+const double LoadMeter::BUSY_RATIO = 0.9;
+
+LoadMeter::LoadMeter(): busy(false) {
+  clock_gettime(CLOCK_MONOTONIC, &this->wall);
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &this->cpu);
+}
+
+bool LoadMeter::isBusy() {
+  struct timespec wall;
+  struct timespec cpu;
+
+  clock_gettime(CLOCK_MONOTONIC, &wall);
+  double window = elapsed(this->wall, wall);
+  if (window < 1)
+    return this->busy;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+  this->busy = elapsed(this->cpu, cpu) / window > BUSY_RATIO;
+  this->wall = wall;
+  this->cpu = cpu;
+  return this->busy;
+}
+
+double LoadMeter::elapsed(const struct timespec& from, const struct timespec& to) {
+  return (to.tv_sec - from.tv_sec) + (to.tv_nsec - from.tv_nsec) / 1e9;
+}
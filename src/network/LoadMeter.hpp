@@ -0,0 +1,29 @@
+#ifndef LOAD_METER_HPP
+# define LOAD_METER_HPP
+
+# include <time.h>
+
+/*
+ * How much of a CPU the calling thread has used, measured over windows of
+ * about a second. Each event loop keeps its own; optional work such as
+ * compression is skipped while the loop is saturated.
+ */
+class LoadMeter {
+  public:
+    // Share of the window spent on the CPU above which the loop counts as busy
+    static const double       BUSY_RATIO;
+
+    LoadMeter();
+
+    // Closes the window once it is a second old, so the answer lags by up to that
+    bool                      isBusy();
+
+  private:
+    struct timespec           wall;
+    struct timespec           cpu;
+    bool                      busy;
+
+    static double             elapsed(const struct timespec& from, const struct timespec& to);
+};
+
+#endif
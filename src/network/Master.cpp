@@ -0,0 +1,140 @@
+#include "./Master.hpp"
+
+const time_t Master::RESPAWN_THROTTLE = 1;
+
+static volatile sig_atomic_t g_terminate = 0;
+
+static void onTerminate(int) {
+  g_terminate = 1;
+}
+
+/*
+ * ==============================================
+ *                 Constructor
+ * ==============================================
+ */
+
+Master::Master(Config& config):
+  config(config),
+  workers(config.getWorkerProcesses(), -1),
+  spawned_at(config.getWorkerProcesses(), 0) {
+}
+
+/*
+ * ==============================================
+ *                 Destructor
+ * ==============================================
+ */
+
+Master::~Master() {}
+
+/*
+ * ==============================================
+ *                   Public
+ * ==============================================
+ */
+
+void Master::run() {
+  struct sigaction sa;
+
+  sa.sa_handler = onTerminate;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = 0;
+  sigaction(SIGTERM, &sa, 0);
+  sigaction(SIGINT, &sa, 0);
+
+  // Writes seen by one worker drop the cached misses of all
+  NegativeCache::share();
+  for (size_t i = 0; i < this->workers.size(); ++i)
+    spawn(i);
+  logger::info << "Master(" << getpid() << ") started " << this->workers.size() << " workers" << logger::endl;
+
+  supervise();
+  shutdown();
+}
+
+void Master::work(Config& config) {
+  if (config.getWorkerThreads() > 0) {
+    Acceptor acceptor(config);
+    acceptor.run();
+  }
+  else {
+    SessionManager sessionManager;
+    Server server(config, sessionManager);
+    server.run();
+  }
+}
+
+/*
+ * ==============================================
+ *                   Workers
+ * ==============================================
+ */
+
+void Master::spawn(size_t idx) {
+  pid_t pid = fork();
+
+  if (pid == -1) {
+    logger::error << "fork worker(" << idx << ") failed" << logger::endl;
+    return;
+  }
+
+  if (pid == 0) {
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    try {
+      work(this->config);
+    } catch (std::exception& e) {
+      logger::error << "worker(" << idx << "): " << e.what() << logger::endl;
+      exit(EXIT_FAILURE);
+    }
+    exit(EXIT_SUCCESS);
+  }
+
+  this->workers[idx] = pid;
+  this->spawned_at[idx] = time(NULL);
+  logger::info << "Spawned, worker(" << idx << ") pid " << pid << logger::endl;
+}
+
+void Master::supervise() {
+  while (!g_terminate) {
+    int   status;
+    pid_t pid = waitpid(-1, &status, 0);
+
+    if (pid == -1) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    for (size_t i = 0; i < this->workers.size(); ++i) {
+      if (this->workers[i] != pid)
+        continue;
+
+      if (WIFSIGNALED(status))
+        logger::warning << "worker(" << i << ") pid " << pid << " killed by signal " << WTERMSIG(status) << logger::endl;
+      else
+        logger::warning << "worker(" << i << ") pid " << pid << " exited with " << WEXITSTATUS(status) << logger::endl;
+
+      this->workers[i] = -1;
+      // A worker that can't stay up would otherwise be forked in a tight loop
+      if (time(NULL) - this->spawned_at[i] < RESPAWN_THROTTLE)
+        sleep(RESPAWN_THROTTLE);
+      if (!g_terminate)
+        spawn(i);
+      break;
+    }
+  }
+}
+
+void Master::shutdown() {
+  for (size_t i = 0; i < this->workers.size(); ++i) {
+    if (this->workers[i] > 0)
+      kill(this->workers[i], SIGTERM);
+  }
+  for (size_t i = 0; i < this->workers.size(); ++i) {
+    if (this->workers[i] > 0)
+      waitpid(this->workers[i], 0, 0);
+  }
+  logger::info << "Master(" << getpid() << ") stopped" << logger::endl;
+}
@@ -0,0 +1,46 @@
+#ifndef MASTER_HPP
+# define MASTER_HPP
+
+# include "./Acceptor.hpp"
+# include "./Server.hpp"
+# include "./SessionManager.hpp"
+# include "../config/Config.hpp"
+# include "../etc/Logger.hpp"
+
+# include <errno.h>
+# include <signal.h>
+# include <sys/wait.h>
+# include <unistd.h>
+# include <time.h>
+# include <vector>
+
+/*
+ * Forks worker_processes workers, each running its own Server with
+ * SO_REUSEPORT listeners, and respawns the ones that die.
+ */
+class Master {
+  public:
+    Master(Config& config);
+    ~Master();
+
+    void                run();
+    // Body of a worker, the threaded acceptor or a single Server
+    static void         work(Config& config);
+
+  private:
+    static const time_t RESPAWN_THROTTLE;
+
+    Config&             config;
+    // worker index, pid
+    std::vector<pid_t>  workers;
+    std::vector<time_t> spawned_at;
+
+    void                spawn(size_t idx);
+    void                supervise();
+    void                shutdown();
+
+    Master(const Master& obj);
+    Master&             operator=(const Master& obj);
+};
+
+#endif
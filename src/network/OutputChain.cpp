@@ -0,0 +1,250 @@
+#include "./OutputChain.hpp"
+
+const size_t OutputChain::IOV_SIZE = 64;
+const size_t OutputChain::GZIP_CHUNK = 1024 * 64;
+
+OutputChain::Segment::Segment(): pos(0), fd(-1), offset(0), left(0), gzip(false) {}
+
+const char* OutputChain::Segment::bytes() const {
+  return this->shared.empty() ? this->data.data() : this->shared.data();
+}
+
+size_t OutputChain::Segment::length() const {
+  return this->shared.empty() ? this->data.length() : this->shared.length();
+}
+
+/*
+ * ==============================================
+ *                 Constructor
+ * ==============================================
+ */
+
+OutputChain::OutputChain(): deflater(NULL) {}
+
+OutputChain::OutputChain(const OutputChain& obj): segments(obj.segments), deflater(NULL) {}
+
+OutputChain& OutputChain::operator=(const OutputChain& obj) {
+  if (this != &obj) {
+    this->segments = obj.segments;
+    delete this->deflater;
+    this->deflater = NULL;
+  }
+  return *this;
+}
+
+/*
+ * ==============================================
+ *                 Destructor
+ * ==============================================
+ */
+
+OutputChain::~OutputChain() { delete this->deflater; }
+
+/*
+ * ==============================================
+ *                   Public
+ * ==============================================
+ */
+
+void OutputChain::append(std::string& data) {
+  if (data.empty())
+    return;
+  this->segments.push_back(Segment());
+  this->segments.back().data.swap(data);
+}
+
+void OutputChain::append(const SharedBuffer& data) {
+  if (data.empty())
+    return;
+  this->segments.push_back(Segment());
+  this->segments.back().shared = data;
+}
+
+void OutputChain::appendFile(int fd, off_t offset, off_t length) {
+  if (length <= 0)
+    return;
+  this->segments.push_back(Segment());
+  this->segments.back().fd = fd;
+  this->segments.back().offset = offset;
+  this->segments.back().left = length;
+  this->segments.back().gzip = this->deflater != NULL;
+}
+
+bool OutputChain::startGzip(int level) {
+  delete this->deflater;
+  this->deflater = new Deflater;
+  if (this->deflater->init(level))
+    return true;
+  delete this->deflater;
+  this->deflater = NULL;
+  return false;
+}
+
+ssize_t OutputChain::flush(int sock) {
+  ssize_t total = 0;
+
+  while (!this->segments.empty()) {
+    ssize_t sent;
+
+    if (this->segments.front().gzip) {
+      if (!deflateFile())
+        return -1;
+      continue;
+    }
+    if (this->segments.front().fd == -1)
+      sent = writeMemory(sock);
+    else
+      sent = writeFile(sock);
+
+    if (sent == -1 && errno == EAGAIN)
+      break;
+    // 0 from a file means it shrank under us, it can't be finished
+    if (sent <= 0)
+      return -1;
+    total += sent;
+  }
+  return total;
+}
+
+bool OutputChain::empty() const { return this->segments.empty(); }
+
+void OutputChain::clear() {
+  this->segments.clear();
+  delete this->deflater;
+  this->deflater = NULL;
+}
+
+size_t OutputChain::gather(std::string& out, size_t max) const {
+  size_t total = 0;
+
+  for (std::deque<Segment>::const_iterator it = this->segments.begin();
+       it != this->segments.end() && it->fd == -1 && total < max; ++it) {
+    size_t n = std::min(it->length() - it->pos, max - total);
+
+    out.append(it->bytes() + it->pos, n);
+    total += n;
+  }
+  return total;
+}
+
+bool OutputChain::nextRead(int& fd, off_t& offset, size_t& length, size_t max) const {
+  if (this->segments.empty() || this->segments.front().fd == -1)
+    return false;
+
+  const Segment& seg = this->segments.front();
+  fd = seg.fd;
+  offset = seg.offset;
+  length = std::min(static_cast<off_t>(max), seg.left);
+  return true;
+}
+
+void OutputChain::fill(const char* data, size_t length) {
+  Segment&    seg = this->segments.front();
+  bool        gzip = seg.gzip;
+  std::string chunk;
+
+  seg.offset += length;
+  seg.left -= length;
+  bool last = seg.left == 0;
+  if (last)
+    this->segments.pop_front();
+
+  if (!gzip)
+    chunk.assign(data, length);
+  else {
+    std::string out;
+
+    this->deflater->update(data, length, out);
+    if (last)
+      this->deflater->finish(out);
+    if (!out.empty())
+      chunk = util::toHex(out.length()) + "\r\n" + out + "\r\n";
+    if (last)
+      chunk += "0\r\n\r\n";
+  }
+  if (!chunk.empty()) {
+    this->segments.push_front(Segment());
+    this->segments.front().data.swap(chunk);
+  }
+}
+
+void OutputChain::advance(size_t sent) {
+  while (sent > 0) {
+    Segment& seg = this->segments.front();
+
+    if (seg.fd != -1) {
+      seg.offset += sent;
+      seg.left -= sent;
+      sent = 0;
+      if (seg.left == 0)
+        this->segments.pop_front();
+      continue;
+    }
+
+    size_t rest = seg.length() - seg.pos;
+    if (sent < rest) {
+      seg.pos += sent;
+      sent = 0;
+    }
+    else {
+      sent -= rest;
+      this->segments.pop_front();
+    }
+  }
+}
+
+/*
+ * ==============================================
+ *                   Private
+ * ==============================================
+ */
+
+ssize_t OutputChain::writeMemory(int sock) {
+  struct iovec iov[IOV_SIZE];
+  size_t       count = 0;
+
+  for (std::deque<Segment>::iterator it = this->segments.begin();
+       it != this->segments.end() && it->fd == -1 && count < IOV_SIZE; ++it, ++count) {
+    iov[count].iov_base = const_cast<char*>(it->bytes()) + it->pos;
+    iov[count].iov_len = it->length() - it->pos;
+  }
+
+  ssize_t sent = writev(sock, iov, count);
+  if (sent > 0)
+    advance(sent);
+  return sent;
+}
+
+ssize_t OutputChain::writeFile(int sock) {
+  Segment& seg = this->segments.front();
+  ssize_t  sent;
+
+#ifdef __linux__
+  off_t    offset = seg.offset;
+
+  // Straight from the page cache, advance() moves the offset
+  sent = sendfile(sock, seg.fd, &offset, seg.left);
+#else
+  char     buf[1024 * 16];
+
+  sent = pread(seg.fd, buf, std::min(static_cast<off_t>(sizeof(buf)), seg.left), seg.offset);
+  if (sent > 0)
+    sent = send(sock, buf, sent, 0);
+#endif
+  if (sent > 0)
+    advance(sent);
+  return sent;
+}
+
+// Turns the next piece of the front file into a chunk in front of it,
+// only one chunk is held at a time whatever the file size
+bool OutputChain::deflateFile() {
+  Segment&    seg = this->segments.front();
+  std::string buf(std::min(static_cast<off_t>(GZIP_CHUNK), seg.left), '\0');
+
+  ssize_t n = pread(seg.fd, &buf[0], buf.length(), seg.offset);
+  if (n <= 0)
+    return false;
+  fill(buf.data(), n);
+  return true;
+}
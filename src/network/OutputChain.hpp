@@ -0,0 +1,87 @@
+#ifndef OUTPUT_CHAIN_HPP
+# define OUTPUT_CHAIN_HPP
+
+# include "../etc/Deflater.hpp"
+# include "../etc/SharedBuffer.hpp"
+# include "../etc/Util.hpp"
+
+# include <deque>
+# include <string>
+# include <algorithm>
+# include <errno.h>
+# include <unistd.h>
+# include <sys/socket.h>
+# include <sys/types.h>
+# include <sys/uio.h>
+# ifdef __linux__
+#  include <sys/sendfile.h>
+# endif
+
+/*
+ * What is left to send of a response, as a queue of segments.
+ * Memory segments go out together with one writev, file segments with
+ * sendfile; a short write only moves the position of the front segment.
+ * After startGzip() file segments are read, deflated and sent as HTTP
+ * chunks instead, one piece at a time, the stream ends with the last one.
+ * An engine doing the I/O itself (io_uring) gathers the memory, reads the
+ * pieces nextRead() names and hands them back with fill().
+ */
+class OutputChain {
+  public:
+    // Segments gathered by one writev
+    static const size_t       IOV_SIZE;
+    // File bytes read for one deflated chunk
+    static const size_t       GZIP_CHUNK;
+
+    OutputChain();
+    ~OutputChain();
+    OutputChain(const OutputChain& obj);
+    OutputChain&              operator=(const OutputChain& obj);
+
+    // Takes the content of data, which is left empty
+    void                      append(std::string& data);
+    void                      append(const SharedBuffer& data);
+    // length bytes of fd from offset, fd stays owned by the caller
+    void                      appendFile(int fd, off_t offset, off_t length);
+    // For the file segments appended after it, false when zlib fails
+    bool                      startGzip(int level);
+
+    // Bytes sent until the socket is full or the chain empty, -1 on error
+    ssize_t                   flush(int sock);
+    bool                      empty() const;
+    void                      clear();
+
+    // Appends up to max bytes of the memory at the front, 0 before a file
+    size_t                    gather(std::string& out, size_t max) const;
+    // The next piece of the front file segment, false when it is memory
+    bool                      nextRead(int& fd, off_t& offset, size_t& length, size_t max) const;
+    // Bytes read for nextRead(), they take its place, deflated after startGzip()
+    void                      fill(const char* data, size_t length);
+    // Drops sent bytes from the front
+    void                      advance(size_t sent);
+
+  private:
+    struct Segment {
+      std::string             data;
+      SharedBuffer            shared;
+      size_t                  pos;
+      int                     fd;
+      off_t                   offset;
+      off_t                   left;
+      bool                    gzip;
+
+      Segment();
+      const char*             bytes() const;
+      size_t                  length() const;
+    };
+
+    std::deque<Segment>       segments;
+    // A running stream is not copied, a chain is copied before it is filled
+    Deflater*                 deflater;
+
+    ssize_t                   writeMemory(int sock);
+    ssize_t                   writeFile(int sock);
+    bool                      deflateFile();
+};
+
+#endif
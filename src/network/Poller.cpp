@@ -0,0 +1,43 @@
+#include "./Poller.hpp"
+#include "./EpollPoller.hpp"
+#include "./SelectPoller.hpp"
+#include "../etc/Logger.hpp"
+
+
+const std::string Poller::EPOLL = "epoll";
+const std::string Poller::IO_URING = "io_uring";
+const std::string Poller::SELECT = "select";
+
+Poller::Poller() {}
+
+Poller::~Poller() {}
+
+Poller* Poller::create(const std::string& engine) {
+#ifdef __linux__
+  if (engine != SELECT)
+    return new EpollPoller();
+#else
+  if (!engine.empty() && engine != SELECT)
+    logger::warning << engine << " is not available, fall back to " << SELECT << logger::endl;
+#endif
+  return new SelectPoller();
+}
+
+bool Poller::isSet(int fd, int event) const {
+  if (fd < 0 || static_cast<size_t>(fd) >= this->interest.size())
+    return false;
+  return (this->interest[fd] & event) != 0;
+}
+
+int Poller::getReadyFd(int i) const {
+  return this->ready[i].first;
+}
+
+int Poller::getReadyEvents(int i) const {
+  return this->ready[i].second;
+}
+
+void Poller::growInterest(int fd) {
+  if (static_cast<size_t>(fd) >= this->interest.size())
+    this->interest.resize(fd + 1, NONE);
+}
@@ -0,0 +1,57 @@
+#ifndef POLLER_HPP
+# define POLLER_HPP
+
+# include <string>
+# include <vector>
+# include <utility>
+
+/*
+ * Readiness notification used by the server loop.
+ * wait() only reports the fds that are ready, so one loop iteration costs
+ * O(ready events) with the epoll engine. io_uring is no poller, the
+ * Server drives Uring for it.
+ */
+class Poller {
+  public:
+    enum Event {
+      NONE  = 0,
+      READ  = 1 << 0,
+      WRITE = 1 << 1
+    };
+
+    static const std::string          EPOLL;
+    static const std::string          IO_URING;
+    static const std::string          SELECT;
+
+    // The default engine for one that is unavailable or no poller
+    static Poller*                    create(const std::string& engine);
+
+    virtual ~Poller();
+
+    virtual void                      add(int fd, int events) = 0;
+    virtual void                      remove(int fd, int events) = 0;
+    bool                              isSet(int fd, int event) const;
+
+    // Returns the number of ready fds, -1 on error
+    virtual int                       wait(int timeout_ms) = 0;
+    int                               getReadyFd(int i) const;
+    int                               getReadyEvents(int i) const;
+
+    virtual std::string               getEngine() const = 0;
+
+  protected:
+    Poller();
+
+    // fd, interested events
+    std::vector<int>                  interest;
+    // fd, ready events
+    std::vector<std::pair<int, int> > ready;
+
+    void                              growInterest(int fd);
+
+  private:
+    Poller(const Poller& obj);
+    Poller&                           operator=(const Poller& obj);
+};
+
+#endif
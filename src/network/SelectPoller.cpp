@@ -0,0 +1,70 @@
+#include "./SelectPoller.hpp"
+
+#include <stdexcept>
+
+SelectPoller::SelectPoller():
+  Poller(),
+  fdMax(-1) {
+    FD_ZERO(&this->reads);
+    FD_ZERO(&this->writes);
+}
+
+SelectPoller::~SelectPoller() {}
+
+void SelectPoller::add(int fd, int events) {
+  if (fd < 0)
+    return;
+  if (fd >= FD_SETSIZE)
+    throw std::runtime_error("fd exceeds FD_SETSIZE");
+  growInterest(fd);
+
+  if (events & READ)
+    FD_SET(fd, &this->reads);
+  if (events & WRITE)
+    FD_SET(fd, &this->writes);
+  this->interest[fd] |= events;
+  if (this->fdMax < fd)
+    this->fdMax = fd;
+}
+
+void SelectPoller::remove(int fd, int events) {
+  if (fd < 0 || static_cast<size_t>(fd) >= this->interest.size())
+    return;
+
+  if ((events & READ) && FD_ISSET(fd, &this->reads))
+    FD_CLR(fd, &this->reads);
+  if ((events & WRITE) && FD_ISSET(fd, &this->writes))
+    FD_CLR(fd, &this->writes);
+  this->interest[fd] &= ~events;
+  while (this->fdMax >= 0 && this->interest[this->fdMax] == NONE)
+    --this->fdMax;
+}
+
+int SelectPoller::wait(int timeout_ms) {
+  struct timeval  t;
+  fd_set          readsCpy = this->reads;
+  fd_set          writesCpy = this->writes;
+
+  this->ready.clear();
+  t.tv_sec = timeout_ms / 1000;
+  t.tv_usec = (timeout_ms % 1000) * 1000;
+  if (select(this->fdMax + 1, &readsCpy, &writesCpy, 0, timeout_ms < 0 ? 0 : &t) == -1)
+    return errno == EINTR ? 0 : -1;
+
+  for (int fd = 0; fd < this->fdMax + 1; ++fd) {
+    int r = NONE;
+
+    if (FD_ISSET(fd, &readsCpy))
+      r |= READ;
+    if (FD_ISSET(fd, &writesCpy))
+      r |= WRITE;
+    if (r != NONE)
+      this->ready.push_back(std::make_pair(fd, r));
+  }
+
+  return this->ready.size();
+}
+
+std::string SelectPoller::getEngine() const {
+  return SELECT;
+}
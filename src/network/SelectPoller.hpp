@@ -0,0 +1,25 @@
+#ifndef SELECT_POLLER_HPP
+# define SELECT_POLLER_HPP
+
+# include "./Poller.hpp"
+
+# include <sys/select.h>
+# include <errno.h>
+
+class SelectPoller: public Poller {
+  public:
+    SelectPoller();
+    ~SelectPoller();
+
+    void        add(int fd, int events);
+    void        remove(int fd, int events);
+    int         wait(int timeout_ms);
+    std::string getEngine() const;
+
+  private:
+    int         fdMax;
+    fd_set      reads;
+    fd_set      writes;
+};
+
+#endif
@@ -1,12 +1,7 @@
 #include "./Server.hpp"
 
-const size_t        Server::BIND_MAX_TRIES = 10;
-const size_t        Server::LISTEN_MAX_TRIES = 10;
-const size_t        Server::TRY_SLEEP_TIME = 5;
 const size_t        Server::BUF_SIZE = 1024 * 16;
-const size_t        Server::MANAGE_FD_MAX = 1024;
-const std::string   Server::HEADER_DELIMETER = "\r\n\r\n";
-const std::string   Server::CHUNKED_DELIMETER = "0\r\n\r\n";
+const size_t        Server::CHUNK_SIZE = 1024 * 64;
 
 /*
  * ==============================================
@@ -14,14 +9,46 @@ const std::string   Server::CHUNKED_DELIMETER = "0\r\n\r\n";
  * ==============================================
  */
 
-Server::Server(Config& config) :
-  fdMax(-1),
+Server::Server(Config& config, SessionManager& sessionManager) :
+  poller(NULL),
+  ring(NULL),
   config(config),
   connection(config),
-  sessionManager() {
-    FD_ZERO(&this->reads);
-    FD_ZERO(&this->writes);
-    FD_ZERO(&this->listens);
+  sessionManager(sessionManager),
+  inbox(NULL),
+  running(true),
+  fileCache(config.getHttpConfig().getOpenFileCacheMax(),
+            config.getHttpConfig().getOpenFileCacheInactive(),
+            config.getHttpConfig().getOpenFileCacheValid(),
+            config.getHttpConfig().getTypes()),
+  contentCache(config.getHttpConfig().getFileCacheBudget(),
+               config.getHttpConfig().getFileCacheMaxFileSize(),
+               config.getHttpConfig().getOpenFileCacheValid()),
+  missCache(config.getHttpConfig().getNegativeCacheMax(),
+            config.getHttpConfig().getNegativeCacheValid()),
+  errorPages(config.getHttpConfig()) {
+    createEngine(config.getHttpConfig().getIoEngine());
+}
+
+Server::Server(Config& config, SessionManager& sessionManager, FdQueue& inbox) :
+  poller(NULL),
+  ring(NULL),
+  config(config),
+  connection(config),
+  sessionManager(sessionManager),
+  inbox(&inbox),
+  running(true),
+  fileCache(config.getHttpConfig().getOpenFileCacheMax(),
+            config.getHttpConfig().getOpenFileCacheInactive(),
+            config.getHttpConfig().getOpenFileCacheValid(),
+            config.getHttpConfig().getTypes()),
+  contentCache(config.getHttpConfig().getFileCacheBudget(),
+               config.getHttpConfig().getFileCacheMaxFileSize(),
+               config.getHttpConfig().getOpenFileCacheValid()),
+  missCache(config.getHttpConfig().getNegativeCacheMax(),
+            config.getHttpConfig().getNegativeCacheValid()),
+  errorPages(config.getHttpConfig()) {
+    createEngine(config.getHttpConfig().getIoEngine());
 }
 
 /*
@@ -38,6 +65,9 @@ Server::~Server() {
       logger::info << "Closed, server(" << i << ")" << logger::endl;
   }
 
+  delete this->poller;
+  delete this->ring;
+
   logger::info << "Server closed" << logger::endl;
 }
 
@@ -48,10 +78,29 @@ Server::~Server() {
  */
 
 void Server::run() {
-  setup_server();
-  logger::info << "Server setup done" << logger::endl;
-  logger::info << "Server is running..." << logger::endl;
-  loop();
+  try {
+    setup_server();
+    logger::info << "Server setup done, io engine: " << getEngine() << logger::endl;
+    logger::info << "Server is running..." << logger::endl;
+    if (this->ring)
+      loopRing();
+    else
+      loop();
+  } catch (...) {
+    // The acceptor must not hand clients to a reactor that is gone
+    if (this->inbox)
+      this->inbox->abandon();
+    throw;
+  }
+  if (this->inbox)
+    this->inbox->abandon();
+}
+
+void Server::stop() {
+  this->running = false;
+  __sync_synchronize();
+  if (this->inbox)
+    this->inbox->notify();
 }
 
 /*
@@ -60,69 +109,106 @@ void Server::run() {
  * ==============================================
  */
 
-void Server::setup_server() {
-  std::vector<ServerConfig> servers = this->config.getHttpConfig().getServerConfig();
-  for (std::vector<ServerConfig>::iterator sit = servers.begin(); sit != servers.end(); ++sit) {
-    sockaddr_in sock;
-    int         fd;
+void Server::createEngine(const std::string& engine) {
+  if (engine == Poller::IO_URING) {
+    try {
+      this->ring = new Uring();
+      return;
+    } catch (std::exception& e) {
+      this->poller = Poller::create("");
+      logger::warning << "io_uring is not available (" << e.what() << "), fall back to " << this->poller->getEngine() << logger::endl;
+      return;
+    }
+  }
+  this->poller = Poller::create(engine);
+}
 
-    fd = init_socket();
-    this->listens_fd.push_back(fd);
+std::string Server::getEngine() const {
+  if (this->ring)
+    return Poller::IO_URING;
+  return this->poller->getEngine();
+}
+
+void Server::setup_server() {
+  if (this->inbox) {
+    // io_uring waits on the pipe itself, O_NONBLOCK would only fail its reads
+    if (this->ring && fcntl(this->inbox->getReadFd(), F_SETFL, 0) == -1)
+      logger::warning << "inbox fcntl failed" << logger::endl;
+    this->connection.attach(this->inbox->getReadFd(), Connection::INBOX, -1);
+    ft_fd_set(this->inbox->getReadFd(), Poller::READ);
+    return;
+  }
 
-    init_sockaddr_in(sit->getHost(), sit->getPort(), sock);
-    open_socket(fd, sock);
+  // One listener per address, the servers sharing it are told apart by Host
+  const std::vector<std::pair<std::string, short> >& listens = this->config.getHttpConfig().getListens();
+  for (std::vector<std::pair<std::string, short> >::const_iterator it = listens.begin(); it != listens.end(); ++it) {
+    int fd = Listener::open(it->first, it->second, this->config.getWorkerProcesses() > 1);
 
-    ft_fd_set(fd, this->reads);
-    ft_fd_set(fd, this->listens);
+    this->listens_fd.push_back(fd);
+    this->connection.attach(fd, Connection::LISTEN, -1);
+    ft_fd_set(fd, Poller::READ);
   }
 }
 
 void Server::loop() {
-  struct timeval t;
-
-  t.tv_sec = 1;
-  t.tv_usec = 0;
-  while (1) {
+  while (this->running) {
+    int ready = this->poller->wait(this->connection.getNextTimeout());
 
-    fd_set readsCpy = this->reads;
-    fd_set writesCpy = this->writes;
-
-    if (select(this->fdMax + 1, &readsCpy, &writesCpy, 0, &t) == -1) {
-      logger::error << "Select returns -1, break" << logger::endl;
+    if (ready == -1) {
+      logger::error << "Poller returns -1, break" << logger::endl;
       break;
     }
 
     cleanUpConnection();
 
-    for (int i = 0; i < this->fdMax + 1; i++) {
-      if (FD_ISSET(i, &this->writes)) {
-        if (FD_ISSET(i, &writesCpy)) {
-          if (isFileFd(i))
-            writeFile(i);
-          else if (isCgiPipe(i))
-            writeCGI(i);
-          else {
-            HttpResponse::SendStatus send_status = this->responses[i].getSendStatus();
-            if (send_status == HttpResponse::SENDING)
-              sendData(i);
-            else if (send_status == HttpResponse::DONE) {
-              if (this->requests[i].getHeader().getConnection() == HttpRequestHeader::CLOSE)
-                closeConnection(i);
-              else
-                keepAliveConnection(i);
+    for (int i = 0; i < ready; ++i) {
+      int fd = this->poller->getReadyFd(i);
+      int events = this->poller->getReadyEvents(i);
+
+      // A previous event of this iteration may have dropped the fd
+      if (this->poller->isSet(fd, Poller::WRITE)) {
+        if (events & Poller::WRITE) {
+          switch (this->connection.kindOf(fd)) {
+            case Connection::FILE:
+              writeFile(fd);
+              break;
+            case Connection::CGI:
+              writeCGI(fd);
+              break;
+            case Connection::CLIENT: {
+              Connection::Slot& slot = this->connection.at(fd);
+              HttpResponse::SendStatus send_status = slot.response.getSendStatus();
+              if (send_status == HttpResponse::SENDING)
+                sendData(fd);
+              else if (send_status == HttpResponse::DONE)
+                finishResponse(fd);
+              break;
             }
+            default:
+              break;
           }
         }
       }
-      else if (FD_ISSET(i, &readsCpy)) {
-        if (isFileFd(i))
-          readFile(i);
-        else if (isCgiPipe(i))
-          readCGI(i);
-        else if (FD_ISSET(i, &this->listens))
-          acceptConnect(i);
-        else
-          receiveData(i);
+      else if (this->poller->isSet(fd, Poller::READ) && (events & Poller::READ)) {
+        switch (this->connection.kindOf(fd)) {
+          case Connection::FILE:
+            readFile(fd);
+            break;
+          case Connection::CGI:
+            readCGI(fd);
+            break;
+          case Connection::LISTEN:
+            acceptConnect(fd);
+            break;
+          case Connection::INBOX:
+            receiveClients();
+            break;
+          case Connection::CLIENT:
+            receiveData(fd);
+            break;
+          default:
+            break;
+        }
       }
     }
   }
@@ -146,27 +232,46 @@ void Server::acceptConnect(int server_fd) {
     logger::warning << "accept failed" << logger::endl;
     return;
   }
+
+  logger::info << "Accept, client(" << client_fd << ", " << inet_ntoa(client_addr.sin_addr) << ":" << ntohs(client_addr.sin_port) << ") into (" << server_fd << ")" << logger::endl;
+  registerClient(client_fd);
+}
+
+void Server::receiveClients() {
+  int client_fd;
+
+  // The io_uring read took the wake up bytes already
+  if (this->ring == NULL)
+    this->inbox->drain();
+  while (this->inbox->pop(client_fd))
+    registerClient(client_fd);
+}
+
+void Server::registerClient(int client_fd) {
   if (fcntl(client_fd, F_SETFL, O_NONBLOCK) == -1) {
     close(client_fd);
     logger::warning << "accept fcntl failed" << logger::endl;
     return;
   }
 
-  this->requests.insert(std::make_pair(client_fd, HttpRequest()));
-  this->responses.insert(std::make_pair(client_fd, HttpResponse()));
-  this->recvs.insert(std::make_pair(client_fd, std::string()));
+  struct sockaddr_in  local;
+  socklen_t           size = sizeof(local);
 
-  ft_fd_set(client_fd, this->reads);
+  this->connection.attach(client_fd, Connection::CLIENT, -1);
+  if (getsockname(client_fd, (struct sockaddr *)&local, &size) == 0)
+    this->connection.at(client_fd).listen = this->config.getHttpConfig().findListen(local.sin_addr.s_addr, ntohs(local.sin_port));
 
-  logger::info << "Accept, client(" << client_fd << ", " << inet_ntoa(client_addr.sin_addr) << ":" << ntohs(client_addr.sin_port) << ") into (" << server_fd << ")" << logger::endl;
+  ft_fd_set(client_fd, Poller::READ);
   this->connection.update(client_fd, Connection::HEADER);
-
-  return ;
 }
 
 void Server::receiveData(int client_fd) {
-  static char buf[BUF_SIZE + 1];
-  int         recv_size;
+  Connection::Slot& slot = this->connection.at(client_fd);
+  char              buf[BUF_SIZE + 1];
+  int               recv_size;
+
+  if (spliceBody(client_fd, slot.request))
+    return;
 
   recv_size = recv(client_fd, buf, BUF_SIZE, 0);
   if (recv_size <= 0) {
@@ -177,103 +282,172 @@ void Server::receiveData(int client_fd) {
   }
   buf[recv_size] = 0;
   logger::debug << "recv_size(" << client_fd << "): " << recv_size << logger::endl;
-  this->recvs[client_fd] += std::string(buf, recv_size);
-  logger::debug << "total(" << client_fd << "): " << this->recvs[client_fd].length() << logger::endl;
+  slot.recv.append(buf, recv_size);
+  logger::debug << "total(" << client_fd << "): " << slot.recv.length() << logger::endl;
   checkReceiveDone(client_fd);
 }
 
+// Length framed upload going to a file, socket to file without a copy
+bool Server::spliceBody(int client_fd, HttpRequest& req) {
+  Connection::Slot& slot = this->connection.at(client_fd);
+
+  if (!this->splice.isAvailable() || !req.isRecvStatus(HttpRequest::BODY_RECEIVE))
+    return false;
+  if (slot.parser.getFraming() != HttpParser::LENGTH || !req.isBodyInFile() || !slot.recv.empty())
+    return false;
+
+  ssize_t moved;
+  try {
+    moved = this->splice.transfer(client_fd, req.getBodyFd(), req.getContentLength() - req.getBodyLength());
+  } catch (HttpStatus s) {
+    req.setConnection(HttpRequestHeader::CLOSE);
+    req.setError(s);
+    checkReceiveDone(client_fd);
+    return true;
+  }
+  if (moved == -1 && errno == EAGAIN)
+    return true;
+  if (moved <= 0) {
+    if (moved < 0)
+      logger::warning << "splice < 0 with client(" << client_fd  << ")" << logger::endl;
+    closeConnection(client_fd);
+    return true;
+  }
+  logger::debug << "splice_size(" << client_fd << "): " << static_cast<size_t>(moved) << logger::endl;
+  req.addBodyLength(moved);
+  if (req.getBodyLength() == static_cast<size_t>(req.getContentLength()))
+    req.setRecvStatus(HttpRequest::RECEIVE_DONE);
+  checkReceiveDone(client_fd);
+  return true;
+}
+
 void Server::checkReceiveDone(int client_fd) {
-  HttpRequest& req = this->requests[client_fd];
+  Connection::Slot& slot = this->connection.at(client_fd);
+  HttpRequest&      req = slot.request;
 
   if (req.isRecvStatus(HttpRequest::HEADER_RECEIVE))
     receiveHeader(client_fd, req);
 
   if (req.isRecvStatus(HttpRequest::BODY_RECEIVE)) {
-    if (req.getHeader().getTransferEncoding() == HttpRequestHeader::CHUNKED) {
-
-      size_t pos = this->recvs[client_fd].find(CHUNKED_DELIMETER);
-      if (pos != std::string::npos) {
-        req.setBody(this->recvs[client_fd].substr(0, pos));
-        req.setRecvStatus(HttpRequest::RECEIVE_DONE);
-        try {
-          req.unchunkBody();
-        } catch (HttpStatus s) {
-          logger::debug << "Chunked message is wrong" << logger::endl;
-          req.setError(s);
-        }
-      }
-
-    }
-    else if (req.getHeader().getTransferEncoding() == HttpRequestHeader::UNSET) {
-
-      if (req.getContentLength() <= static_cast<int>(recvs[client_fd].length())) {
-        req.setBody(this->recvs[client_fd].substr(0, req.getContentLength()));
-        req.setRecvStatus(HttpRequest::RECEIVE_DONE);
-      }
-
+    try {
+      receiveBody(client_fd, req);
+    } catch (HttpStatus s) {
+      logger::debug << "Request body is wrong" << logger::endl;
+      // What is left of the body is still on the wire
+      req.setConnection(HttpRequestHeader::CLOSE);
+      req.setError(s);
     }
   }
 
+  if (this->ring && req.isBodyInFile())
+    writeBody(client_fd, req);
+
   if (req.isRecvStatus(HttpRequest::RECEIVE_DONE) || req.isRecvStatus(HttpRequest::RECEIVE_ERROR)) {
-    this->recvs.erase(client_fd);
-    this->responses[client_fd] = Http::processing(this->requests[client_fd], this->sessionManager);
+    // The upload is handled once its file is complete
+    if (this->ring && this->ring->isPending(client_fd, Uring::WRITE))
+      return;
+    slot.recv.clear();
+    slot.response = Http::processing(req, this->sessionManager, this->fileCache, this->contentCache, this->missCache,
+                                      this->errorPages);
     prepareIO(client_fd);
   }
 }
 
 void Server::receiveHeader(int client_fd, HttpRequest& req) {
-  size_t pos = this->recvs[client_fd].find(HEADER_DELIMETER);
-
-  if (pos != std::string::npos) {
-    std::string header = this->recvs[client_fd].substr(0, pos);
-    std::string left = this->recvs[client_fd].substr(pos + HEADER_DELIMETER.length());
-    this->recvs[client_fd] = left;
+  Connection::Slot& slot = this->connection.at(client_fd);
+  HttpParser&       parser = slot.parser;
 
-    try {
-      req.parse(header, this->config);
-      logger::info << "Request from " << client_fd << " to " << req.getServerConfig().getServerName() << ", Method=\"" << req.getMethod() << "\" URI=\"" << req.getPath() << "\"" << logger::endl;
-      this->connection.update(client_fd, Connection::BODY);
-    } catch (HttpStatus s) {
-      logger::debug << "Request header message is wrong" << logger::endl;
-      req.setError(s);
+  try {
+    // Resumes where the previous recv stopped
+    if (parser.execute(slot.recv) == HttpParser::AGAIN)
       return;
-    }
+    req.parse(slot.recv, parser, this->config, slot.listen, this->missCache);
+    logger::info << "Request from " << client_fd << " to " << req.getServerConfig().getServerName() << ", Method=\"" << req.getMethod() << "\" URI=\"" << req.getPath() << "\"" << logger::endl;
+    this->connection.update(client_fd, Connection::BODY);
+  } catch (HttpStatus s) {
+    logger::debug << "Request header message is wrong" << logger::endl;
+    req.setError(s);
+    return;
+  }
+  slot.recv.erase(0, parser.getHeaderLength());
 
-    if (req.getHeader().getTransferEncoding() == HttpRequestHeader::CHUNKED)
+  size_t max_body_size = req.getLocationConfig().getClientMaxBodySize();
+  switch (parser.getFraming()) {
+    case HttpParser::CHUNKED:
+      slot.chunked.reset(max_body_size);
       req.setRecvStatus(HttpRequest::BODY_RECEIVE);
-    else {
-      std::string contentLength = req.getHeader().get(HttpRequestHeader::CONTENT_LENGTH);
-      if (contentLength.empty())
-        req.setRecvStatus(HttpRequest::RECEIVE_DONE);
-      else {
-        req.setContentLength(util::atoi(contentLength));
-        req.setRecvStatus(HttpRequest::BODY_RECEIVE);
+      break;
+    case HttpParser::LENGTH:
+      // Refused before the body is read
+      if (static_cast<size_t>(parser.getContentLength()) > max_body_size) {
+        req.setConnection(HttpRequestHeader::CLOSE);
+        req.setError(PAYLOAD_TOO_LARGE);
+        break;
       }
+      req.setContentLength(parser.getContentLength());
+      req.setRecvStatus(HttpRequest::BODY_RECEIVE);
+      break;
+    case HttpParser::NONE:
+      req.setRecvStatus(HttpRequest::RECEIVE_DONE);
+      break;
+  }
+  // File uploads are written as they arrive instead of held in memory
+  if (req.isRecvStatus(HttpRequest::BODY_RECEIVE) && Http::prepareUpload(req) && this->ring)
+    req.holdBodyWrites();
+}
+
+void Server::receiveBody(int client_fd, HttpRequest& req) {
+  Connection::Slot& slot = this->connection.at(client_fd);
+
+  if (slot.parser.getFraming() == HttpParser::CHUNKED) {
+    size_t used;
+
+    ChunkedDecoder::Result result = slot.chunked.decode(slot.recv, used, req);
+    slot.recv.erase(0, used);
+    if (result == ChunkedDecoder::DONE) {
+      req.addTrailers(slot.chunked.getTrailers());
+      req.setRecvStatus(HttpRequest::RECEIVE_DONE);
     }
   }
+  else {
+    size_t left = req.getContentLength() - req.getBodyLength();
+    size_t used = std::min(left, slot.recv.length());
+
+    req.appendBody(slot.recv.data(), used);
+    slot.recv.erase(0, used);
+    if (used == left)
+      req.setRecvStatus(HttpRequest::RECEIVE_DONE);
+  }
 }
 
 // I/O
 
 void Server::prepareIO(int client_fd) {
-  HttpRequest&  req = this->requests[client_fd];
-  HttpResponse& res = this->responses[client_fd];
+  Connection::Slot& slot = this->connection.at(client_fd);
+  HttpRequest&      req = slot.request;
+  HttpResponse&     res = slot.response;
 
   if (res.getCgiStatus() == HttpResponse::IS_CGI) {
     CGI& cgi = res.getCGI();
     this->connection.updateGateway(client_fd, req.getServerConfig());
-    ft_fd_set(cgi.getWriteFD(), this->writes);
-    cgi_map.insert(std::make_pair(cgi.getWriteFD(), client_fd));
+    this->connection.attach(cgi.getWriteFD(), Connection::CGI, client_fd);
+    ft_fd_set(cgi.getWriteFD(), Poller::WRITE);
   }
   else if (res.getCgiStatus() == HttpResponse::NOT_CGI) {
     this->connection.update(client_fd, Connection::SEND);
-    if (res.isSetFd()) {
+    struct stat _stat;
+
+    // Regular files are not read up front, sendData streams them
+    if (res.isSetFd() && !res.isFileBody() && isReadFd(req, res) && fstat(res.getFd(), &_stat) == 0 && S_ISREG(_stat.st_mode))
+      res.setFileBody(_stat.st_size);
+
+    if (res.isSetFd() && !res.isFileBody()) {
       int fileFd = res.getFd();
-      file_map.insert(std::make_pair(fileFd, client_fd));
+      this->connection.attach(fileFd, Connection::FILE, client_fd);
       if (isReadFd(req, res))
-        ft_fd_set(fileFd, this->reads);
+        ft_fd_set(fileFd, Poller::READ);
       else
-        ft_fd_set(fileFd, this->writes);
+        ft_fd_set(fileFd, Poller::WRITE);
     }
     else
       postProcessing(client_fd);
@@ -289,15 +463,17 @@ bool Server::isReadFd(const HttpRequest& req, const HttpResponse& res) {
 // Send
 
 void Server::postProcessing(int client_fd) {
-  HttpRequest&  req = this->requests[client_fd];
-  HttpResponse& res = this->responses[client_fd];
-
-  if (req.getMethod() == request_method::HEAD) {
-    res.getHeader().remove(HttpRequestHeader::CONTENT_TYPE);
-    res.removeBody();
-  }
+  Connection::Slot& slot = this->connection.at(client_fd);
+  HttpRequest&      req = slot.request;
+  HttpResponse&     res = slot.response;
+
+  if (req.getMethod() == request_method::HEAD)
+    res.omitBody();
+  // Under CPU pressure bodies go out as they are
+  else if (req.getLocationConfig().isGzip() && !this->load.isBusy())
+    Http::applyGzip(req, res);
   addExtraHeader(client_fd, req, res);
-  ft_fd_set(client_fd, this->writes);
+  ft_fd_set(client_fd, Poller::WRITE);
   logger::info << "Response to " << client_fd << " from " << req.getServerConfig().getServerName() << ", Status=" << res.getStatusCode() << logger::endl;
 }
 
@@ -327,17 +503,30 @@ void Server::addExtraHeader(int client_fd, HttpRequest& req, HttpResponse& res)
 }
 
 void Server::sendData(int client_fd) {
-  HttpResponse& res = this->responses[client_fd];
-  std::string   data = res.toString();
-  int           send_size;
+  HttpResponse& res = this->connection.at(client_fd).response;
+  OutputChain&  output = res.getOutput();
+  ssize_t       send_size;
 
-  if ((send_size = send(client_fd, data.c_str(), data.length(), 0)) <= 0) {
-    if (send_size == -1)
-      logger::warning << "send_size < 0 with client(" << client_fd  << ")" << logger::endl;
+  if ((send_size = output.flush(client_fd)) == -1) {
+    logger::warning << "send failed with client(" << client_fd  << ")" << logger::endl;
     closeConnection(client_fd);
+    return;
   }
+  logger::debug << "send_size(" << client_fd << "): " << static_cast<size_t>(send_size) << logger::endl;
+  // send_timeout counts from the last progress, not from the response start
+  if (send_size > 0)
+    this->connection.update(client_fd, Connection::SEND);
+  if (output.empty() && res.isFileBody() && res.isSetFd()) {
+    close(res.getFd());
+    res.unsetFd();
+  }
+}
+
+void Server::finishResponse(int client_fd) {
+  if (this->connection.at(client_fd).request.getHeader().getConnection() == HttpRequestHeader::CLOSE)
+    closeConnection(client_fd);
   else
-    res.addSendLength(send_size);
+    keepAliveConnection(client_fd);
 }
 
 /*
@@ -347,49 +536,50 @@ void Server::sendData(int client_fd) {
  */
 
 void Server::closeConnection(int client_fd) {
-  HttpResponse& res = this->responses[client_fd];
+  HttpResponse& res = this->connection.at(client_fd).response;
 
-  ft_fd_clr(client_fd, this->writes);
-  ft_fd_clr(client_fd, this->reads);
-  if (client_fd == this->fdMax)
-    --this->fdMax;
+  ft_fd_clr(client_fd, Poller::WRITE);
+  ft_fd_clr(client_fd, Poller::READ);
   if (close(client_fd) == -1)
     logger::warning << "Closed, client(" << client_fd << ") with -1" << logger::endl;
   else
     logger::info << "Closed, client(" << client_fd << ")" << logger::endl;
-  this->connection.remove(client_fd);
-  this->connection.removeRequests(client_fd);
 
   if (res.isSetFd()) {
+    ft_fd_clr(res.getFd(), Poller::READ);
+    ft_fd_clr(res.getFd(), Poller::WRITE);
     close(res.getFd());
-    ft_fd_clr(res.getFd(), this->reads);
-    ft_fd_clr(res.getFd(), this->writes);
-    file_map.erase(res.getFd());
+    this->connection.release(res.getFd());
   }
 
   if (res.getCgiStatus() == HttpResponse::IS_CGI) {
     CGI& cgi = res.getCGI();
 
     cgi.withdrawResource();
-    ft_fd_clr(cgi.getReadFD(), this->reads);
-    ft_fd_clr(cgi.getWriteFD(), this->writes);
-    cgi_map.erase(cgi.getReadFD());
-    cgi_map.erase(cgi.getWriteFD());
+    ft_fd_clr(cgi.getReadFD(), Poller::READ);
+    ft_fd_clr(cgi.getWriteFD(), Poller::WRITE);
+    this->connection.release(cgi.getReadFD());
+    this->connection.release(cgi.getWriteFD());
   }
 
-  this->requests.erase(client_fd);
-  this->responses.erase(client_fd);
-  this->recvs.erase(client_fd);
+  this->connection.release(client_fd);
 }
 
 void Server::keepAliveConnection(int client_fd) {
-  ft_fd_clr(client_fd, this->writes);
-
-  this->connection.updateKeepAlive(client_fd, this->requests[client_fd].getServerConfig());
-
-  this->requests.erase(client_fd);
-  this->responses.erase(client_fd);
-  this->recvs.erase(client_fd);
+  Connection::Slot& slot = this->connection.at(client_fd);
+  std::string       early;
+
+  ft_fd_clr(client_fd, Poller::WRITE);
+
+  this->connection.updateKeepAlive(client_fd, slot.request.getServerConfig());
+  // What io_uring received before its recv stopped is the next request
+  early.swap(slot.recv);
+  this->connection.reset(client_fd);
+  slot.recv.swap(early);
+  if (!slot.recv.empty())
+    checkReceiveDone(client_fd);
+  if (this->ring)
+    updateRecv(client_fd);
 }
 
 /*
@@ -399,20 +589,21 @@ void Server::keepAliveConnection(int client_fd) {
  */
 
 void Server::cleanUpConnection() {
-  std::set<int> fd_list;
+  std::vector<int> fd_list;
 
   fd_list = this->connection.getTimeoutList();
-  for (std::set<int>::iterator it = fd_list.begin(); it != fd_list.end(); ++it) {
-    int           fd = *it;
-    HttpRequest&  req = this->requests[fd];
-    HttpResponse& res = this->responses[fd];
-    std::string   what;
+  for (std::vector<int>::iterator it = fd_list.begin(); it != fd_list.end(); ++it) {
+    int               fd = *it;
+    Connection::Slot& slot = this->connection.at(fd);
+    HttpRequest&      req = slot.request;
+    HttpResponse&     res = slot.response;
+    std::string       what;
 
     if (req.isRecvStatus(HttpRequest::HEADER_RECEIVE) || req.isRecvStatus(HttpRequest::BODY_RECEIVE)) {
       what = "Request ";
 
-      ft_fd_clr(fd, this->reads);
-      res = Http::getErrorPage(REQUEST_TIMEOUT, req);
+      ft_fd_clr(fd, Poller::READ);
+      res = Http::getErrorPage(REQUEST_TIMEOUT, req, this->errorPages);
       req.setConnection(HttpRequestHeader::CLOSE);
       prepareIO(fd);
     }
@@ -420,14 +611,14 @@ void Server::cleanUpConnection() {
       what = "Gateway ";
       CGI& cgi = res.getCGI();
 
-      this->cgi_map.erase(cgi.getReadFD());
-      this->cgi_map.erase(cgi.getWriteFD());
-      ft_fd_clr(cgi.getReadFD(), this->reads);
-      ft_fd_clr(cgi.getWriteFD(), this->writes);
+      this->connection.release(cgi.getReadFD());
+      this->connection.release(cgi.getWriteFD());
+      ft_fd_clr(cgi.getReadFD(), Poller::READ);
+      ft_fd_clr(cgi.getWriteFD(), Poller::WRITE);
 
       cgi.withdrawResource();
 
-      res = Http::getErrorPage(GATEWAY_TIMEOUT, req);
+      res = Http::getErrorPage(GATEWAY_TIMEOUT, req, this->errorPages);
       req.setConnection(HttpRequestHeader::CLOSE);
       res.setCgiStatus(HttpResponse::NOT_CGI);
       prepareIO(fd);
@@ -444,61 +635,74 @@ void Server::cleanUpConnection() {
  * ==============================================
  */
 
-bool Server::isCgiPipe(int fd) const {
-  std::map<int, int>::const_iterator it;
-
-  it = this->cgi_map.find(fd);
-  if (it == this->cgi_map.end())
-    return false;
-  return it->second;
-}
-
 void Server::writeCGI(int fd) {
-  int   client_fd  = cgi_map[fd];
-  CGI&  cgi = this->responses[client_fd].getCGI();
+  int               client_fd = this->connection.at(fd).owner;
+  CGI&              cgi = this->connection.at(client_fd).response.getCGI();
 
   int write_size = cgi.writeCGI();
-  if (write_size <= 0) {
-    ft_fd_clr(fd, this->writes);
-    cgi_map.erase(fd);
-    if (write_size < 0) {
-      logger::error << "cgi write error" << logger::endl;
-      cgi.withdrawResource();
-      this->responses[client_fd] = Http::getErrorPage(INTERNAL_SERVER_ERROR, this->requests[client_fd]);
-      prepareIO(client_fd);
-    }
-    else {
-      lseek(fd, 0, SEEK_SET);
-      try {
-        cgi.forkCGI();
-        ft_fd_set(cgi.getReadFD(), this->reads);
-        cgi_map.insert(std::make_pair(cgi.getReadFD(), client_fd));
-      } catch (HttpStatus s) {
-        this->responses[client_fd] = Http::getErrorPage(s, this->requests[client_fd]);
-        prepareIO(client_fd);
-      }
-    }
-  }
+  if (write_size <= 0)
+    onWriteCGI(fd, write_size);
 }
 
 void Server::readCGI(int fd) {
-  int   client_fd = cgi_map[fd];
-  CGI&  cgi = this->responses[client_fd].getCGI();
+  int               client_fd = this->connection.at(fd).owner;
+  CGI&              cgi = this->connection.at(client_fd).response.getCGI();
 
-  int read_size = cgi.readCGI();
-  if (read_size <= 0) {
-    ft_fd_clr(fd, this->reads);
-    cgi_map.erase(fd);
+  onReadCGI(fd, cgi.readCGI());
+}
+
+// The body is in the temporary file once write_size is not positive or
+// io_uring wrote all of it
+void Server::onWriteCGI(int fd, int write_size) {
+  int               client_fd = this->connection.at(fd).owner;
+  Connection::Slot& slot = this->connection.at(client_fd);
+  CGI&              cgi = slot.response.getCGI();
+
+  ft_fd_clr(fd, Poller::WRITE);
+  this->connection.release(fd);
+  if (write_size < 0) {
+    logger::error << "cgi write error" << logger::endl;
     cgi.withdrawResource();
-    if (read_size < 0) {
-      logger::error << "cgi read error" << logger::endl;
-      this->responses[client_fd] = Http::getErrorPage(INTERNAL_SERVER_ERROR, this->requests[client_fd]);
+    slot.response = Http::getErrorPage(INTERNAL_SERVER_ERROR, slot.request, this->errorPages);
+    prepareIO(client_fd);
+  }
+  else {
+    lseek(fd, 0, SEEK_SET);
+    try {
+      cgi.forkCGI();
+      // io_uring waits on the pipe itself, O_NONBLOCK would only fail its reads
+      if (this->ring && fcntl(cgi.getReadFD(), F_SETFL, 0) == -1)
+        logger::warning << "cgi pipe fcntl failed" << logger::endl;
+      this->connection.attach(cgi.getReadFD(), Connection::CGI, client_fd);
+      ft_fd_set(cgi.getReadFD(), Poller::READ);
+    } catch (HttpStatus s) {
+      slot.response = Http::getErrorPage(s, slot.request, this->errorPages);
       prepareIO(client_fd);
     }
-    else {
-      Http::finishCGI(this->responses[client_fd], this->requests[client_fd], this->sessionManager);
-      postProcessing(client_fd);
-    }
+  }
+}
+
+void Server::onReadCGI(int fd, int read_size) {
+  int               client_fd = this->connection.at(fd).owner;
+  Connection::Slot& slot = this->connection.at(client_fd);
+  CGI&              cgi = slot.response.getCGI();
+
+  if (read_size > 0) {
+    if (this->ring)
+      ft_fd_set(fd, Poller::READ);
+    return;
+  }
+  ft_fd_clr(fd, Poller::READ);
+  this->connection.release(fd);
+  cgi.withdrawResource();
+  if (read_size < 0) {
+    logger::error << "cgi read error" << logger::endl;
+    slot.response = Http::getErrorPage(INTERNAL_SERVER_ERROR, slot.request, this->errorPages);
+    prepareIO(client_fd);
+  }
+  else {
+    Http::finishCGI(slot.response, slot.request, this->sessionManager, this->errorPages);
+    postProcessing(client_fd);
   }
 }
 
@@ -508,141 +712,330 @@ void Server::readCGI(int fd) {
  * ==============================================
  */
 
-bool Server::isFileFd(int fd) const {
-  std::map<int, int>::const_iterator it;
+void Server::writeFile(int fd) {
+  int           client_fd = this->connection.at(fd).owner;
+  HttpResponse& res = this->connection.at(client_fd).response;
 
-  it = this->file_map.find(fd);
-  if (it == this->file_map.end())
-    return false;
-  return it->second;
+  std::string data = res.getFileBufferOffSet();
+  int writeSize = write(fd, data.c_str(), data.length());
+  if (writeSize > 0)
+    res.addOffSet(writeSize);
+  else
+    onWriteFile(fd, writeSize);
 }
 
-void Server::writeFile(int fd) {
-  int           client_fd = this->file_map[fd];
-  HttpResponse& res = this->responses[client_fd];
-  HttpRequest&  req = this->requests[client_fd];
-  int           writeSize;
+void Server::readFile(int fd) {
+  char          buf[BUF_SIZE];
 
-  std::string data = res.getFileBufferOffSet();
-  writeSize = write(fd, data.c_str(), data.length());
-  if (writeSize <= 0) {
-    ft_fd_clr(fd, this->writes);
-    this->file_map.erase(fd);
-    close(fd);
-    if (writeSize < 0) {
-      logger::error << "write file failed" << logger::endl;
-      res = Http::getErrorPage(INTERNAL_SERVER_ERROR, req);
-      prepareIO(client_fd);
-    }
-    else
-      postProcessing(client_fd);
+  onReadFile(fd, buf, read(fd, buf, BUF_SIZE));
+}
+
+// The buffer is in the file once writeSize is not positive or io_uring
+// wrote all of it
+void Server::onWriteFile(int fd, int writeSize) {
+  int           client_fd = this->connection.at(fd).owner;
+  HttpResponse& res = this->connection.at(client_fd).response;
+  HttpRequest&  req = this->connection.at(client_fd).request;
+
+  ft_fd_clr(fd, Poller::WRITE);
+  this->connection.release(fd);
+  close(fd);
+  if (writeSize < 0) {
+    logger::error << "write file failed" << logger::endl;
+    res = Http::getErrorPage(INTERNAL_SERVER_ERROR, req, this->errorPages);
+    prepareIO(client_fd);
   }
   else
-    res.addOffSet(writeSize);
+    postProcessing(client_fd);
 }
 
-void Server::readFile(int fd) {
-  char          buf[BUF_SIZE + 1];
-  int           read_size;
-  int           client_fd = this->file_map[fd];
-  HttpResponse& res = this->responses[client_fd];
-  HttpRequest&  req = this->requests[client_fd];
+void Server::onReadFile(int fd, const char* data, int read_size) {
+  int           client_fd = this->connection.at(fd).owner;
+  HttpResponse& res = this->connection.at(client_fd).response;
+  HttpRequest&  req = this->connection.at(client_fd).request;
 
-  read_size = read(fd, buf, BUF_SIZE);
-  if (read_size <= 0) {
-    ft_fd_clr(fd, this->reads);
-    this->file_map.erase(fd);
-    close(fd);
-    if (read_size < 0) {
-      logger::error << "read file failed" << logger::endl;
-      res = Http::getErrorPage(INTERNAL_SERVER_ERROR, req);
-      prepareIO(client_fd);
-    }
-    else {
-      res.setBody(res.getFileBuffer());
-      postProcessing(client_fd);
-    }
+  if (read_size > 0) {
+    res.addFileBuffer(std::string(data, read_size));
+    if (this->ring)
+      ft_fd_set(fd, Poller::READ);
+    return;
+  }
+  ft_fd_clr(fd, Poller::READ);
+  this->connection.release(fd);
+  close(fd);
+  if (read_size < 0) {
+    logger::error << "read file failed" << logger::endl;
+    res = Http::getErrorPage(INTERNAL_SERVER_ERROR, req, this->errorPages);
+    prepareIO(client_fd);
   }
   else {
-    buf[read_size] = 0;
-    res.addFileBuffer(std::string(buf, read_size));
+    res.setBody(res.getFileBuffer());
+    postProcessing(client_fd);
   }
 }
 
 /*
  * ==============================================
- *                Select Utility
+ *                    io_uring
  * ==============================================
  */
 
-void Server::ft_fd_set(int fd, fd_set& set) {
-  FD_SET(fd, &set);
-  if (this->fdMax < fd)
-    this->fdMax = fd;
+void Server::loopRing() {
+  while (this->running) {
+    int ready = this->ring->wait(this->connection.getNextTimeout());
+
+    if (ready == -1) {
+      logger::error << "io_uring returns -1, break" << logger::endl;
+      break;
+    }
+
+    cleanUpConnection();
+
+    for (int i = 0; i < ready; ++i) {
+      // A previous completion of this iteration may have dropped the fd
+      const Uring::Completion* c = this->ring->getCompletion(i);
+      if (c != NULL)
+        complete(*c);
+    }
+  }
 }
 
-void Server::ft_fd_clr(int fd, fd_set& set) {
-  if (FD_ISSET(fd, &set))
-    FD_CLR(fd, &set);
+void Server::complete(const Uring::Completion& c) {
+  switch (this->connection.kindOf(c.key)) {
+    case Connection::LISTEN:
+      onAccept(c.key, c.res);
+      break;
+    case Connection::INBOX:
+      if (c.res <= 0) {
+        logger::error << "inbox read failed" << logger::endl;
+        break;
+      }
+      receiveClients();
+      ft_fd_set(c.key, Poller::READ);
+      break;
+    case Connection::CLIENT:
+      if (c.op == Uring::RECV)
+        onRecv(c.key, c.data, c.res);
+      else if (c.op == Uring::SEND)
+        onSend(c.key, c.res);
+      else if (c.op == Uring::READ)
+        onSendFile(c.key, c.data, c.res);
+      else
+        onWriteBody(c.key, c.res);
+      break;
+    case Connection::FILE:
+      if (c.op == Uring::READ)
+        onReadFile(c.key, c.data, c.res);
+      else
+        onWriteFile(c.key, c.res);
+      break;
+    case Connection::CGI:
+      if (c.op == Uring::WRITE) {
+        onWriteCGI(c.key, c.res);
+        break;
+      }
+      if (c.res > 0)
+        this->connection.at(this->connection.at(c.key).owner).response.getCGI().addCgiResult(c.data, c.res);
+      onReadCGI(c.key, c.res);
+      break;
+    default:
+      break;
+  }
 }
 
-/*
- * ==============================================
- *                Server Utility
- * ==============================================
- */
+// The op an event of fd stands for, the loop's interest in it
+void Server::submitIO(int fd, Poller::Event event) {
+  Connection::Slot& slot = this->connection.at(fd);
+  std::string       data;
+
+  switch (slot.kind) {
+    case Connection::LISTEN:
+      this->ring->accept(fd);
+      break;
+    case Connection::INBOX:
+    case Connection::FILE:
+      if (event == Poller::READ) {
+        this->ring->read(fd, fd, -1, BUF_SIZE);
+        break;
+      }
+      data = this->connection.at(slot.owner).response.getFileBufferOffSet();
+      this->ring->write(fd, fd, -1, data);
+      break;
+    case Connection::CGI:
+      if (event == Poller::READ) {
+        this->ring->read(fd, fd, -1, BUF_SIZE);
+        break;
+      }
+      data = this->connection.at(slot.owner).response.getCGI().getBodyLeft();
+      this->ring->write(fd, fd, -1, data);
+      break;
+    case Connection::CLIENT:
+      if (event == Poller::READ) {
+        // Multishot, armed once for the connection
+        if (!this->ring->isPending(fd, Uring::RECV))
+          this->ring->recv(fd);
+      }
+      else if (!this->ring->isPending(fd, Uring::SEND | Uring::READ))
+        submitSend(fd);
+      break;
+    default:
+      break;
+  }
+}
 
-int Server::init_socket() {
-  int fd = socket(AF_INET, SOCK_STREAM, 0);
-  if (fd == -1)
-    throw std::runtime_error("Server initialization failed");
+// One piece of the response at a time: memory is copied into the send,
+// files are read first, the response ends when nothing is left
+void Server::submitSend(int client_fd) {
+  OutputChain&  output = this->connection.at(client_fd).response.getOutput();
+  std::string   data;
+  int           fd;
+  off_t         offset;
+  size_t        length;
+
+  if (output.gather(data, CHUNK_SIZE) > 0)
+    this->ring->send(client_fd, data);
+  else if (output.nextRead(fd, offset, length, CHUNK_SIZE))
+    this->ring->read(client_fd, fd, offset, length);
+  else
+    finishResponse(client_fd);
+}
 
-//  int option = 1;
-//  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+// What the decoders kept of an upload, written at its offset. One write
+// at a time, what comes meanwhile is kept in the request until it is done
+void Server::writeBody(int client_fd, HttpRequest& req) {
+  std::string data;
 
-  return fd;
+  if (this->ring->isPending(client_fd, Uring::WRITE))
+    return;
+  off_t offset = req.takeHeldBody(data);
+  if (!data.empty())
+    this->ring->write(client_fd, req.getBodyFd(), offset, data);
 }
 
-void Server::init_sockaddr_in(const std::string& host, int port, sockaddr_in& in) {
-  if (!memset(&in, 0, sizeof(in)))
-    throw std::runtime_error("Server initialization failed");
+// Reads only while a request comes in and its upload keeps up, the socket
+// buffer holds the rest meanwhile as it does for the poller loop
+void Server::updateRecv(int client_fd) {
+  HttpRequest& req = this->connection.at(client_fd).request;
 
-  in.sin_family = AF_INET;
-  inet_pton(AF_INET, host.c_str(), &(in.sin_addr));
-  in.sin_port = htons(port);
+  if ((req.isRecvStatus(HttpRequest::HEADER_RECEIVE) || req.isRecvStatus(HttpRequest::BODY_RECEIVE))
+      && !this->ring->isPending(client_fd, Uring::WRITE))
+    ft_fd_set(client_fd, Poller::READ);
+  else
+    this->ring->stop(client_fd, Uring::RECV);
+}
 
-  logger::info << "Preparing... Host=[" << inet_ntoa(in.sin_addr) << "] Port=[" << ntohs(in.sin_port) << "]" << logger::endl;
+void Server::onAccept(int server_fd, int client_fd) {
+  if (client_fd < 0)
+    logger::warning << "accept failed" << logger::endl;
+  else {
+    logger::info << "Accept, client(" << client_fd << ") into (" << server_fd << ")" << logger::endl;
+    registerClient(client_fd);
+  }
+  // A multishot accept ended, by an error or an old kernel
+  if (!this->ring->isPending(server_fd, Uring::ACCEPT))
+    this->ring->accept(server_fd);
 }
 
-void Server::open_socket(int server_fd, sockaddr_in& in) {
-  bool  bind_success = false;
-  bool  listen_success = false;
+void Server::onRecv(int client_fd, const char* data, int recv_size) {
+  Connection::Slot& slot = this->connection.at(client_fd);
+  HttpRequest&      req = slot.request;
+  bool              receiving = req.isRecvStatus(HttpRequest::HEADER_RECEIVE) || req.isRecvStatus(HttpRequest::BODY_RECEIVE);
 
-  for (size_t i = 0; i < BIND_MAX_TRIES; ++i) {
-    if (bind(server_fd, (struct sockaddr*)&in, sizeof(in)) == -1)
-      logger::warning << "Bind failed... retry... " << i + 1 << logger::endl;
-    else {
-      bind_success = true;
-      break;
+  if (recv_size <= 0) {
+    // Stopped by updateRecv(), which decides again
+    if (recv_size == -ECANCELED) {
+      updateRecv(client_fd);
+      return;
+    }
+    // Done sending, the client still gets the response it asked for
+    if (recv_size == 0 && !receiving) {
+      req.setConnection(HttpRequestHeader::CLOSE);
+      return;
     }
-    sleep(TRY_SLEEP_TIME);
+    if (recv_size < 0)
+      logger::warning << "recv_size < 0 with client(" << client_fd  << ")" << logger::endl;
+    closeConnection(client_fd);
+    return;
+  }
+  logger::debug << "recv_size(" << client_fd << "): " << recv_size << logger::endl;
+  slot.recv.append(data, recv_size);
+  logger::debug << "total(" << client_fd << "): " << slot.recv.length() << logger::endl;
+  // Bytes that came before the recv stopped wait for keepAliveConnection()
+  if (receiving)
+    checkReceiveDone(client_fd);
+  updateRecv(client_fd);
+}
+
+void Server::onSend(int client_fd, int send_size) {
+  HttpResponse& res = this->connection.at(client_fd).response;
+  OutputChain&  output = res.getOutput();
+
+  if (send_size <= 0) {
+    logger::warning << "send failed with client(" << client_fd  << ")" << logger::endl;
+    closeConnection(client_fd);
+    return;
+  }
+  logger::debug << "send_size(" << client_fd << "): " << send_size << logger::endl;
+  output.advance(send_size);
+  // send_timeout counts from the last progress, not from the response start
+  this->connection.update(client_fd, Connection::SEND);
+  if (output.empty() && res.isFileBody() && res.isSetFd()) {
+    close(res.getFd());
+    res.unsetFd();
   }
+  submitSend(client_fd);
+}
 
-  if (bind_success == false)
-    throw std::runtime_error("Server bind failed");
+void Server::onSendFile(int client_fd, const char* data, int read_size) {
+  // 0 means the file shrank under us, it can't be finished
+  if (read_size <= 0) {
+    logger::warning << "read failed for client(" << client_fd  << ")" << logger::endl;
+    closeConnection(client_fd);
+    return;
+  }
+  this->connection.at(client_fd).response.getOutput().fill(data, read_size);
+  submitSend(client_fd);
+}
 
-  for (size_t i = 0; i < LISTEN_MAX_TRIES; ++i) {
-    if (listen(server_fd, MANAGE_FD_MAX) == -1)
-      logger::warning << "Listen failed... retry... " << i + 1 << logger::endl;
-    else {
-      listen_success = true;
-      break;
-    }
-    sleep(TRY_SLEEP_TIME);
+void Server::onWriteBody(int client_fd, int write_size) {
+  HttpRequest& req = this->connection.at(client_fd).request;
+
+  if (write_size < 0) {
+    logger::error << "write body failed" << logger::endl;
+    // What is left of the body is still on the wire
+    req.setConnection(HttpRequestHeader::CLOSE);
+    req.setError(INTERNAL_SERVER_ERROR);
+  }
+  if (req.isRecvStatus(HttpRequest::RECEIVE_DONE) || req.isRecvStatus(HttpRequest::RECEIVE_ERROR))
+    checkReceiveDone(client_fd);
+  else {
+    writeBody(client_fd, req);
+    updateRecv(client_fd);
   }
+}
+
+/*
+ * ==============================================
+ *                Poller Utility
+ * ==============================================
+ */
 
-  if (listen_success == false)
-    throw std::runtime_error("Server listen failed");
+// On io_uring the op the event stands for is submitted
+void Server::ft_fd_set(int fd, Poller::Event event) {
+  if (this->ring)
+    submitIO(fd, event);
+  else
+    this->poller->add(fd, event);
+}
 
-  logger::info << "Listening... (" << server_fd << ") \n\n\"http://" << inet_ntoa(in.sin_addr) << ":" << ntohs(in.sin_port) << "\"\n" << logger::endl;
+// On io_uring its ops are cancelled
+void Server::ft_fd_clr(int fd, Poller::Event event) {
+  if (this->ring) {
+    if (event == Poller::READ)
+      this->ring->cancel(fd, Uring::ACCEPT | Uring::RECV | Uring::READ);
+    else
+      this->ring->cancel(fd, Uring::SEND | Uring::WRITE);
+  }
+  else
+    this->poller->remove(fd, event);
 }
@@ -2,6 +2,12 @@
 # define SERVER_HPP
 
 # include "./Connection.hpp"
+# include "./FdQueue.hpp"
+# include "./Listener.hpp"
+# include "./LoadMeter.hpp"
+# include "./Poller.hpp"
+# include "./SplicePipe.hpp"
+# include "./Uring.hpp"
 # include "../etc/Logger.hpp"
 # include "../etc/Util.hpp"
 # include "./SessionManager.hpp"
@@ -13,51 +19,55 @@
 
 # include <signal.h>
 # include <arpa/inet.h>
+# include <errno.h>
 # include <fcntl.h>
 # include <time.h>
 # include <unistd.h>
 # include <vector>
 # include <sys/socket.h>
+# include <sys/stat.h>
 
 class Server {
   public:
-    Server(Config& config);
+    Server(Config& config, SessionManager& sessionManager);
+    // Reactor of the threaded mode, clients come from the acceptor through inbox
+    Server(Config& config, SessionManager& sessionManager, FdQueue& inbox);
     ~Server();
 
     void run();
+    // Callable from another thread, the loop ends at its next wake up
+    void stop();
 
   private:
-    static const size_t         BIND_MAX_TRIES;
-    static const size_t         LISTEN_MAX_TRIES;
-    static const size_t         TRY_SLEEP_TIME;
     static const size_t         BUF_SIZE;
-    static const size_t         MANAGE_FD_MAX;
+    // Bytes one io_uring send or file read moves
+    static const size_t         CHUNK_SIZE;
 
-    static const std::string    HEADER_DELIMETER;
-    static const std::string    CHUNKED_DELIMETER;
 
     std::vector<int>            listens_fd;
-    std::map<int, HttpRequest>  requests;
-    std::map<int, HttpResponse> responses;
-    std::map<int, std::string>  recvs;
-
-    std::map<int, int>          cgi_map;
-    std::map<int, int>          file_map;
-
-    int                         fdMax;
-    fd_set                      listens;
-    fd_set                      reads;
-    fd_set                      writes;
+    Poller*                     poller;
+    // Does the I/O itself when io_engine is io_uring, poller is NULL then
+    Uring*                      ring;
 
     const Config&               config;
     Connection                  connection;
-    SessionManager              sessionManager;
+    SessionManager&             sessionManager;
+    FdQueue*                    inbox;
+    volatile bool               running;
+    SplicePipe                  splice;
+    OpenFileCache               fileCache;
+    ContentCache                contentCache;
+    NegativeCache               missCache;
+    ErrorPages                  errorPages;
+    LoadMeter                   load;
 
     /*
      * ==============================================
      *                 Server core
      * ==============================================
      */
+    void  createEngine(const std::string& engine);
+    std::string getEngine() const;
     void  setup_server();
     void  loop();
 
@@ -68,9 +78,13 @@ class Server {
      */
     // Receive
     void  acceptConnect(int server_fd);
+    void  receiveClients();
+    void  registerClient(int client_fd);
     void  receiveData(int client_fd);
+    bool  spliceBody(int client_fd, HttpRequest& req);
     void  checkReceiveDone(int client_fd);
     void  receiveHeader(int client_fd, HttpRequest& req);
+    void  receiveBody(int client_fd, HttpRequest& req);
 
     // I/O
     void  prepareIO(int client_fd);
@@ -80,6 +94,7 @@ class Server {
     void  postProcessing(int client_fd);
     void  addExtraHeader(int client_fd, HttpRequest& req, HttpResponse& res);
     void  sendData(int client_fd);
+    void  finishResponse(int client_fd);
 
     /*
      * ==============================================
@@ -101,35 +116,45 @@ class Server {
      *                   CGI I/O
      * ==============================================
      */
-    bool  isCgiPipe(int fd) const;
     void  writeCGI(int fd);
     void  readCGI(int fd);
+    void  onWriteCGI(int fd, int write_size);
+    void  onReadCGI(int fd, int read_size);
 
     /*
      * ==============================================
      *                   File I/O
      * ==============================================
      */
-    bool  isFileFd(int fd) const;
     void  writeFile(int fd);
     void  readFile(int fd);
+    void  onWriteFile(int fd, int write_size);
+    void  onReadFile(int fd, const char* data, int read_size);
 
     /*
      * ==============================================
-     *                Select Utility
+     *                    io_uring
      * ==============================================
      */
-    void  ft_fd_set(int fd, fd_set& set);
-    void  ft_fd_clr(int fd, fd_set& set);
+    void  loopRing();
+    void  complete(const Uring::Completion& c);
+    void  submitIO(int fd, Poller::Event event);
+    void  submitSend(int client_fd);
+    void  writeBody(int client_fd, HttpRequest& req);
+    void  updateRecv(int client_fd);
+    void  onAccept(int server_fd, int client_fd);
+    void  onRecv(int client_fd, const char* data, int recv_size);
+    void  onSend(int client_fd, int send_size);
+    void  onSendFile(int client_fd, const char* data, int read_size);
+    void  onWriteBody(int client_fd, int write_size);
 
     /*
      * ==============================================
-     *                Server Utility
+     *                Poller Utility
      * ==============================================
      */
-    int   init_socket();
-    void  init_sockaddr_in(const std::string& host, int port, sockaddr_in& in);
-    void  open_socket(int server_fd, sockaddr_in& in);
+    void  ft_fd_set(int fd, Poller::Event event);
+    void  ft_fd_clr(int fd, Poller::Event event);
 };
 
 #endif
@@ -0,0 +1,62 @@
+#include "./SplicePipe.hpp"
+
+// Default pipe capacity, one splice never has to wait for the reader
+const size_t SplicePipe::CHUNK = 1024 * 64;
+
+SplicePipe::SplicePipe() {
+  this->pipe_fd[0] = -1;
+  this->pipe_fd[1] = -1;
+#ifdef __linux__
+  if (pipe(this->pipe_fd) == -1)
+    return;
+  if (fcntl(this->pipe_fd[0], F_SETFL, O_NONBLOCK) == -1 ||
+      fcntl(this->pipe_fd[1], F_SETFL, O_NONBLOCK) == -1) {
+    close(this->pipe_fd[0]);
+    close(this->pipe_fd[1]);
+    this->pipe_fd[0] = -1;
+    this->pipe_fd[1] = -1;
+  }
+#endif
+}
+
+SplicePipe::~SplicePipe() {
+  if (this->pipe_fd[0] != -1) {
+    close(this->pipe_fd[0]);
+    close(this->pipe_fd[1]);
+  }
+}
+
+bool SplicePipe::isAvailable() const { return this->pipe_fd[0] != -1; }
+
+ssize_t SplicePipe::transfer(int in, int out, size_t len) {
+#ifdef __linux__
+  ssize_t filled = splice(in, NULL, this->pipe_fd[1], NULL, std::min(len, CHUNK), SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+  if (filled <= 0)
+    return filled;
+
+  ssize_t left = filled;
+  while (left > 0) {
+    ssize_t moved = splice(this->pipe_fd[0], NULL, out, NULL, left, SPLICE_F_MOVE);
+    if (moved <= 0) {
+      // Leftovers would end up in the next client's file
+      drain();
+      throw INTERNAL_SERVER_ERROR;
+    }
+    left -= moved;
+  }
+  return filled;
+#else
+  (void)in;
+  (void)out;
+  (void)len;
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+void SplicePipe::drain() {
+  char buf[4096];
+
+  while (read(this->pipe_fd[0], buf, sizeof(buf)) > 0)
+    ;
+}
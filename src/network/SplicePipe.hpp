@@ -0,0 +1,38 @@
+#ifndef SPLICE_PIPE_HPP
+# define SPLICE_PIPE_HPP
+
+# include "../http/HttpStatus.hpp"
+
+# include <algorithm>
+# include <errno.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/types.h>
+
+/*
+ * Moves upload bytes from a socket to a file inside the kernel.
+ * splice() needs a pipe on one side, so each loop keeps one and empties
+ * it before returning; the pages never reach user space.
+ */
+class SplicePipe {
+  public:
+    static const size_t CHUNK;
+
+    SplicePipe();
+    ~SplicePipe();
+
+    // false off Linux or when the pipe could not be made
+    bool                isAvailable() const;
+    // Bytes written to out, 0 on EOF, -1 with errno set when in had nothing
+    ssize_t             transfer(int in, int out, size_t len);
+
+  private:
+    int                 pipe_fd[2];
+
+    void                drain();
+
+    SplicePipe(const SplicePipe& obj);
+    SplicePipe&         operator=(const SplicePipe& obj);
+};
+
+#endif
@@ -0,0 +1,187 @@
+#include "./TimerWheel.hpp"
+
+TimerWheel::Node::Node(): prev(NULL), next(NULL), expire(0), fd(-1), bucket(-1) {}
+
+bool TimerWheel::Node::isArmed() const {
+  return this->bucket != -1;
+}
+
+TimerWheel::TimerWheel(): current(now()), count(0) {
+  for (int i = 0; i < LEVELS * SLOTS; ++i) {
+    this->buckets[i].prev = &this->buckets[i];
+    this->buckets[i].next = &this->buckets[i];
+  }
+  for (int i = 0; i < LEVELS; ++i)
+    this->occupied[i] = 0;
+}
+
+TimerWheel::~TimerWheel() {}
+
+TimerWheel::msec_t TimerWheel::now() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<msec_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*
+ * ==============================================
+ *                 Arm / Cancel
+ * ==============================================
+ */
+
+void TimerWheel::arm(Node& node, msec_t expire) {
+  cancel(node);
+  node.expire = expire;
+  link(node);
+  ++this->count;
+}
+
+void TimerWheel::cancel(Node& node) {
+  if (!node.isArmed())
+    return;
+
+  node.prev->next = node.next;
+  node.next->prev = node.prev;
+  Node& head = this->buckets[node.bucket];
+  if (head.next == &head)
+    this->occupied[node.bucket / SLOTS] &= ~(1ULL << (node.bucket % SLOTS));
+  node.prev = NULL;
+  node.next = NULL;
+  node.bucket = -1;
+  --this->count;
+}
+
+void TimerWheel::link(Node& node) {
+  msec_t  expire = node.expire;
+  int     level = 0;
+
+  if (expire < this->current)
+    expire = this->current;
+  // Beyond the last level, parked at its far end and cascaded again later
+  if (expire - this->current >= 1ULL << (LEVELS * BITS))
+    expire = this->current + (1ULL << (LEVELS * BITS)) - 1;
+  while (level < LEVELS - 1 && expire - this->current >= 1ULL << ((level + 1) * BITS))
+    ++level;
+
+  int   idx = (expire >> (level * BITS)) & (SLOTS - 1);
+  Node& head = this->buckets[level * SLOTS + idx];
+
+  node.bucket = level * SLOTS + idx;
+  node.prev = head.prev;
+  node.next = &head;
+  head.prev->next = &node;
+  head.prev = &node;
+  this->occupied[level] |= 1ULL << idx;
+}
+
+/*
+ * ==============================================
+ *                    Expire
+ * ==============================================
+ */
+
+void TimerWheel::cascade(int level) {
+  int   idx = (this->current >> (level * BITS)) & (SLOTS - 1);
+  Node& head = this->buckets[level * SLOTS + idx];
+  Node  list;
+
+  if (head.next != &head) {
+    // Moved out first, a timer is never linked back into the bucket being drained
+    list.next = head.next;
+    list.prev = head.prev;
+    list.next->prev = &list;
+    list.prev->next = &list;
+    head.next = &head;
+    head.prev = &head;
+    this->occupied[level] &= ~(1ULL << idx);
+
+    while (list.next != &list) {
+      Node* node = list.next;
+
+      list.next = node->next;
+      node->next->prev = &list;
+      link(*node);
+    }
+  }
+  if (idx == 0 && level + 1 < LEVELS)
+    cascade(level + 1);
+}
+
+void TimerWheel::expire(msec_t now, std::vector<int>& fds) {
+  if (this->count == 0) {
+    if (now >= this->current)
+      this->current = now + 1;
+    return;
+  }
+
+  while (this->current <= now) {
+    int                 idx = this->current & (SLOTS - 1);
+    unsigned long long  ahead = this->occupied[0] >> idx;
+
+    if (ahead == 0) {
+      // Nothing left in this turn of the lowest wheel
+      msec_t turn = (this->current | (SLOTS - 1)) + 1;
+      forward(turn <= now ? turn : now + 1);
+      continue;
+    }
+
+    msec_t due = this->current + __builtin_ctzll(ahead);
+    if (due > now) {
+      this->current = now + 1;
+      break;
+    }
+
+    Node& head = this->buckets[due & (SLOTS - 1)];
+    while (head.next != &head) {
+      Node* node = head.next;
+
+      fds.push_back(node->fd);
+      cancel(*node);
+    }
+    forward(due + 1);
+  }
+}
+
+void TimerWheel::forward(msec_t to) {
+  this->current = to;
+  // Entering a new turn, the buckets of the upper levels that are due come down
+  if ((to & (SLOTS - 1)) == 0)
+    cascade(1);
+}
+
+int TimerWheel::nextTimeout(msec_t now) const {
+  if (this->count == 0)
+    return -1;
+
+  msec_t  next = ~0ULL;
+  int     idx = this->current & (SLOTS - 1);
+
+  if (this->occupied[0] >> idx)
+    next = this->current + __builtin_ctzll(this->occupied[0] >> idx);
+  else if (this->occupied[0])
+    next = ((this->current >> BITS) + 1) << BITS | __builtin_ctzll(this->occupied[0]);
+
+  // Higher levels only need a wake up when their bucket cascades
+  for (int level = 1; level < LEVELS; ++level) {
+    if (this->occupied[level] == 0)
+      continue;
+
+    msec_t  turn = this->current >> (level * BITS);
+    int     pos = turn & (SLOTS - 1);
+    for (int step = 1; step <= SLOTS; ++step) {
+      if (this->occupied[level] & (1ULL << ((pos + step) & (SLOTS - 1)))) {
+        msec_t at = (turn + step) << (level * BITS);
+        if (at < next)
+          next = at;
+        break;
+      }
+    }
+  }
+
+  if (next <= now)
+    return 0;
+  if (next - now > 0x7fffffff)
+    return 0x7fffffff;
+  return static_cast<int>(next - now);
+}
@@ -0,0 +1,63 @@
+#ifndef TIMER_WHEEL_HPP
+# define TIMER_WHEEL_HPP
+
+# include <time.h>
+# include <vector>
+
+/*
+ * Hierarchical timing wheel with millisecond ticks.
+ * LEVELS wheels of SLOTS buckets, level n covers SLOTS^(n+1) ms; timers are
+ * cascaded down a level when the lower wheel wraps. Nodes are intrusive
+ * (embedded in the connection slot), so arm and cancel are O(1) and
+ * expire() only touches the buckets that are due.
+ */
+class TimerWheel {
+  public:
+    typedef unsigned long long  msec_t;
+
+    struct Node {
+      Node*                     prev;
+      Node*                     next;
+      msec_t                    expire;
+      int                       fd;
+      // level * SLOTS + bucket, -1 when not armed
+      int                       bucket;
+
+      Node();
+      bool                      isArmed() const;
+    };
+
+    TimerWheel();
+    ~TimerWheel();
+
+    void                        arm(Node& node, msec_t expire);
+    void                        cancel(Node& node);
+
+    // Unlinks the timers due at now and appends their fds
+    void                        expire(msec_t now, std::vector<int>& fds);
+    // Milliseconds the loop may sleep, -1 when no timer is armed
+    int                         nextTimeout(msec_t now) const;
+
+    static msec_t               now();
+
+  private:
+    static const int            LEVELS = 4;
+    static const int            BITS = 6;
+    static const int            SLOTS = 1 << BITS;
+
+    Node                        buckets[LEVELS * SLOTS];
+    // one bit per non empty bucket of each level
+    unsigned long long          occupied[LEVELS];
+    // next tick to process
+    msec_t                      current;
+    size_t                      count;
+
+    void                        link(Node& node);
+    void                        cascade(int level);
+    void                        forward(msec_t to);
+
+    TimerWheel(const TimerWheel& obj);
+    TimerWheel&                 operator=(const TimerWheel& obj);
+};
+
+#endif
@@ -0,0 +1,648 @@
+#include "./Uring.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+
+# include <cstring>
+# include <csignal>
+# include <linux/io_uring.h>
+# include <sys/syscall.h>
+# include <sys/mman.h>
+# include <sys/socket.h>
+# include <poll.h>
+# include <errno.h>
+# include <unistd.h>
+
+const unsigned            Uring::ENTRIES = 4096;
+const unsigned            Uring::BUFFERS = 256;
+const size_t              Uring::BUFFER_SIZE = 1024 * 16;
+const unsigned long long  Uring::IGNORE_TAG = ~0ULL;
+
+Uring::Request::Request():
+  key(-1), fd(-1), op(READ), offset(0), length(0), done(0),
+  inflight(false), reported(false), cancelled(false), stopped(false),
+  multishot(false), punted(false) {}
+
+/*
+ * ==============================================
+ *                 Constructor
+ * ==============================================
+ */
+
+Uring::Uring():
+  ring_fd(-1),
+  sq_ring(MAP_FAILED),
+  sq_ring_size(0),
+  cq_ring(MAP_FAILED),
+  cq_ring_size(0),
+  sqes(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+  sqes_size(0),
+  sq_local_tail(0),
+  buf_ring(NULL),
+  buffers(NULL),
+  buf_tail(0),
+  multishot_accept(true),
+  multishot_recv(true),
+  inflight(0) {
+    try {
+      setup();
+      probe();
+      setupBuffers();
+    } catch (std::exception& e) {
+      release();
+      throw;
+    }
+}
+
+/*
+ * ==============================================
+ *                 Destructor
+ * ==============================================
+ */
+
+Uring::~Uring() {
+  drain();
+  release();
+}
+
+/*
+ * ==============================================
+ *                   Public
+ * ==============================================
+ */
+
+void Uring::accept(int fd) {
+  submit(allocate(fd, fd, ACCEPT), 0);
+}
+
+void Uring::recv(int fd) {
+  unsigned index = allocate(fd, fd, RECV);
+
+  if (this->buf_ring == NULL)
+    this->requests[index].buffer.resize(BUFFER_SIZE);
+  submit(index, 0);
+}
+
+void Uring::send(int fd, std::string& data) {
+  unsigned index = allocate(fd, fd, SEND);
+
+  this->requests[index].buffer.swap(data);
+  this->requests[index].length = this->requests[index].buffer.length();
+  submit(index, 0);
+}
+
+void Uring::read(int key, int fd, off_t offset, size_t length) {
+  unsigned index = allocate(key, fd, READ);
+
+  this->requests[index].offset = offset;
+  this->requests[index].length = length;
+  this->requests[index].buffer.resize(length);
+  submit(index, 0);
+}
+
+void Uring::write(int key, int fd, off_t offset, std::string& data) {
+  unsigned index = allocate(key, fd, WRITE);
+
+  this->requests[index].offset = offset;
+  this->requests[index].buffer.swap(data);
+  this->requests[index].length = this->requests[index].buffer.length();
+  submit(index, 0);
+}
+
+void Uring::cancel(int key, int ops) {
+  if (key < 0 || static_cast<size_t>(key) >= this->keys.size())
+    return;
+
+  std::vector<unsigned>& list = this->keys[key];
+  for (size_t i = 0; i < list.size(); ++i) {
+    Request& r = this->requests[list[i]];
+
+    if (r.cancelled || !(r.op & ops))
+      continue;
+    r.cancelled = true;
+    if (!r.inflight)
+      continue;
+
+    // By user_data, the fd number may belong to someone else by now
+    struct io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = list[i];
+    sqe->user_data = IGNORE_TAG;
+  }
+}
+
+void Uring::stop(int key, int ops) {
+  if (key < 0 || static_cast<size_t>(key) >= this->keys.size())
+    return;
+
+  std::vector<unsigned>& list = this->keys[key];
+  for (size_t i = 0; i < list.size(); ++i) {
+    Request& r = this->requests[list[i]];
+
+    if (r.cancelled || r.stopped || !r.inflight || !(r.op & ops))
+      continue;
+    r.stopped = true;
+
+    // A starved recv is not in the kernel, it just ends
+    std::vector<unsigned>::iterator it = std::find(this->starved.begin(), this->starved.end(), list[i]);
+    if (it != this->starved.end()) {
+      this->starved.erase(it);
+      --this->inflight;
+      r.inflight = false;
+      r.reported = true;
+      this->retired.push_back(list[i]);
+      continue;
+    }
+
+    struct io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = list[i];
+    sqe->user_data = IGNORE_TAG;
+  }
+}
+
+bool Uring::isPending(int key, int ops) const {
+  if (key < 0 || static_cast<size_t>(key) >= this->keys.size())
+    return false;
+
+  const std::vector<unsigned>& list = this->keys[key];
+  for (size_t i = 0; i < list.size(); ++i) {
+    const Request& r = this->requests[list[i]];
+
+    if ((r.inflight || !r.reported) && !r.cancelled && (r.op & ops))
+      return true;
+  }
+  return false;
+}
+
+int Uring::wait(int timeout_ms) {
+  recycle();
+  this->completions.clear();
+
+  __sync_synchronize();
+  unsigned min_complete = (*this->cq_head == *this->cq_tail) ? 1 : 0;
+  if (enter(min_complete, min_complete ? timeout_ms : 0) == -1
+      && errno != ETIME && errno != EINTR && errno != EBUSY)
+    return -1;
+
+  reap();
+  return this->completions.size();
+}
+
+const Uring::Completion* Uring::getCompletion(int i) const {
+  const Completion& c = this->completions[i];
+  const Request&    r = this->requests[c.request];
+
+  if (r.cancelled)
+    return NULL;
+  r.reported = true;
+  return &c;
+}
+
+/*
+ * ==============================================
+ *                   Ring
+ * ==============================================
+ */
+
+void Uring::setup() {
+  struct io_uring_params p;
+
+  std::memset(&p, 0, sizeof(p));
+  this->ring_fd = syscall(__NR_io_uring_setup, ENTRIES, &p);
+  if (this->ring_fd == -1)
+    throw std::runtime_error(std::strerror(errno));
+  if (!(p.features & IORING_FEAT_EXT_ARG))
+    throw std::runtime_error("kernel lacks IORING_FEAT_EXT_ARG");
+  if (!(p.features & IORING_FEAT_RW_CUR_POS))
+    throw std::runtime_error("kernel lacks IORING_FEAT_RW_CUR_POS");
+
+  this->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  this->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    if (this->cq_ring_size > this->sq_ring_size)
+      this->sq_ring_size = this->cq_ring_size;
+    this->cq_ring_size = this->sq_ring_size;
+  }
+
+  this->sq_ring = mmap(0, this->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_fd, IORING_OFF_SQ_RING);
+  if (this->sq_ring == MAP_FAILED)
+    throw std::runtime_error("io_uring sq ring mmap failed");
+  if (p.features & IORING_FEAT_SINGLE_MMAP)
+    this->cq_ring = this->sq_ring;
+  else {
+    this->cq_ring = mmap(0, this->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_fd, IORING_OFF_CQ_RING);
+    if (this->cq_ring == MAP_FAILED)
+      throw std::runtime_error("io_uring cq ring mmap failed");
+  }
+  this->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+  this->sqes = static_cast<struct io_uring_sqe*>(mmap(0, this->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_fd, IORING_OFF_SQES));
+  if (this->sqes == MAP_FAILED)
+    throw std::runtime_error("io_uring sqes mmap failed");
+
+  char* sq = static_cast<char*>(this->sq_ring);
+  char* cq = static_cast<char*>(this->cq_ring);
+
+  this->sq_head = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+  this->sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+  this->sq_mask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+  this->sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+  this->sq_entries = p.sq_entries;
+  this->sq_local_tail = *this->sq_tail;
+
+  this->cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+  this->cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+  this->cq_mask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+  this->cqes = reinterpret_cast<struct io_uring_cqe*>(cq + p.cq_off.cqes);
+}
+
+void Uring::probe() {
+  static const int        needed[] = {
+    IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND, IORING_OP_READ,
+    IORING_OP_WRITE, IORING_OP_ASYNC_CANCEL, IORING_OP_POLL_ADD
+  };
+  const unsigned          ops = 256;
+  std::vector<char>       mem(sizeof(struct io_uring_probe) + ops * sizeof(struct io_uring_probe_op), 0);
+  struct io_uring_probe*  p = reinterpret_cast<struct io_uring_probe*>(&mem[0]);
+
+  if (syscall(__NR_io_uring_register, this->ring_fd, IORING_REGISTER_PROBE, p, ops) == -1)
+    throw std::runtime_error("io_uring probe failed");
+  for (size_t i = 0; i < sizeof(needed) / sizeof(needed[0]); ++i) {
+    if (needed[i] > p->last_op || !(p->ops[needed[i]].flags & IO_URING_OP_SUPPORTED))
+      throw std::runtime_error("kernel lacks an io_uring op");
+  }
+}
+
+// Without them (before 5.19) recv reads into a buffer of its own request
+void Uring::setupBuffers() {
+  size_t                  ring_size = BUFFERS * sizeof(struct io_uring_buf);
+  struct io_uring_buf_reg reg;
+
+  void* ring = mmap(0, ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ring == MAP_FAILED)
+    return;
+
+  std::memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = reinterpret_cast<unsigned long long>(ring);
+  reg.ring_entries = BUFFERS;
+  reg.bgid = 0;
+  if (syscall(__NR_io_uring_register, this->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+    munmap(ring, ring_size);
+    this->multishot_recv = false;
+    return;
+  }
+
+  this->buf_ring = static_cast<struct io_uring_buf*>(ring);
+  this->buffers = new char[BUFFERS * BUFFER_SIZE];
+  for (unsigned bid = 0; bid < BUFFERS; ++bid)
+    provide(bid);
+  __sync_synchronize();
+  this->buf_ring[0].resv = this->buf_tail;
+}
+
+void Uring::release() {
+  if (this->sqes != MAP_FAILED)
+    munmap(this->sqes, this->sqes_size);
+  if (this->cq_ring != MAP_FAILED && this->cq_ring != this->sq_ring)
+    munmap(this->cq_ring, this->cq_ring_size);
+  if (this->sq_ring != MAP_FAILED)
+    munmap(this->sq_ring, this->sq_ring_size);
+  if (this->ring_fd != -1)
+    close(this->ring_fd);
+  if (this->buf_ring != NULL)
+    munmap(this->buf_ring, BUFFERS * sizeof(struct io_uring_buf));
+  delete[] this->buffers;
+  this->sqes = static_cast<struct io_uring_sqe*>(MAP_FAILED);
+  this->cq_ring = MAP_FAILED;
+  this->sq_ring = MAP_FAILED;
+  this->ring_fd = -1;
+  this->buf_ring = NULL;
+  this->buffers = NULL;
+}
+
+// The ring is torn down asynchronously, the memory of every op must
+// outlive it, so they are cancelled and waited for first
+void Uring::drain() {
+  for (size_t i = 0; i < this->keys.size(); ++i)
+    cancel(i, ACCEPT | RECV | SEND | READ | WRITE);
+  for (int tries = 0; this->inflight > 0 && tries < 50; ++tries) {
+    recycle();
+    if (enter(1, 100) == -1 && errno != ETIME && errno != EINTR && errno != EBUSY)
+      break;
+    reap();
+  }
+}
+
+int Uring::enter(unsigned min_complete, int timeout_ms) {
+  struct io_uring_getevents_arg arg;
+  struct __kernel_timespec      ts;
+  unsigned                      flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+  unsigned                      submit;
+
+  std::memset(&arg, 0, sizeof(arg));
+  arg.sigmask_sz = _NSIG / 8;
+  if (timeout_ms >= 0) {
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000LL;
+    arg.ts = reinterpret_cast<unsigned long long>(&ts);
+  }
+
+  __sync_synchronize();
+  *this->sq_tail = this->sq_local_tail;
+  __sync_synchronize();
+  submit = this->sq_local_tail - *this->sq_head;
+
+  return syscall(__NR_io_uring_enter, this->ring_fd, submit, min_complete, flags, &arg, sizeof(arg));
+}
+
+struct io_uring_sqe* Uring::getSqe() {
+  __sync_synchronize();
+  while (this->sq_local_tail - *this->sq_head >= this->sq_entries) {
+    // Ring is full, push what we have without waiting
+    if (enter(0, 0) == -1 && errno != EINTR && errno != EBUSY)
+      throw std::runtime_error("io_uring_enter failed");
+    __sync_synchronize();
+  }
+
+  unsigned idx = this->sq_local_tail & *this->sq_mask;
+  struct io_uring_sqe* sqe = &this->sqes[idx];
+
+  std::memset(sqe, 0, sizeof(*sqe));
+  this->sq_array[idx] = idx;
+  ++this->sq_local_tail;
+  return sqe;
+}
+
+/*
+ * ==============================================
+ *                   Requests
+ * ==============================================
+ */
+
+unsigned Uring::allocate(int key, int fd, Op op) {
+  unsigned index;
+
+  if (this->free_requests.empty()) {
+    index = this->requests.size();
+    this->requests.push_back(Request());
+  }
+  else {
+    index = this->free_requests.back();
+    this->free_requests.pop_back();
+  }
+
+  Request& r = this->requests[index];
+  r.key = key;
+  r.fd = fd;
+  r.op = op;
+  r.offset = 0;
+  r.length = 0;
+  r.done = 0;
+  r.reported = false;
+  r.cancelled = false;
+  r.stopped = false;
+  r.punted = false;
+
+  if (static_cast<size_t>(key) >= this->keys.size())
+    this->keys.resize(key + 1);
+  this->keys[key].push_back(index);
+  return index;
+}
+
+void Uring::submit(unsigned index, unsigned flags) {
+  Request&             r = this->requests[index];
+  struct io_uring_sqe* sqe = getSqe();
+
+  sqe->fd = r.fd;
+  sqe->flags = flags;
+  sqe->user_data = index;
+  r.multishot = false;
+  switch (r.op) {
+    case ACCEPT:
+      sqe->opcode = IORING_OP_ACCEPT;
+      r.multishot = this->multishot_accept;
+      if (r.multishot)
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+      break;
+    case RECV:
+      sqe->opcode = IORING_OP_RECV;
+      if (this->buf_ring == NULL) {
+        sqe->addr = reinterpret_cast<unsigned long long>(&r.buffer[0]);
+        sqe->len = r.buffer.length();
+        break;
+      }
+      sqe->flags |= IOSQE_BUFFER_SELECT;
+      sqe->buf_group = 0;
+      r.multishot = this->multishot_recv;
+      if (r.multishot)
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+      break;
+    case SEND:
+      sqe->opcode = IORING_OP_SEND;
+      sqe->addr = reinterpret_cast<unsigned long long>(r.buffer.data());
+      sqe->len = r.length;
+      sqe->msg_flags = MSG_NOSIGNAL;
+      break;
+    case READ:
+    case WRITE:
+      sqe->opcode = r.op == READ ? IORING_OP_READ : IORING_OP_WRITE;
+      sqe->addr = reinterpret_cast<unsigned long long>(r.buffer.data());
+      sqe->len = r.length;
+      sqe->off = r.offset == -1 ? ~0ULL : static_cast<unsigned long long>(r.offset);
+      break;
+  }
+
+  if (!r.inflight)
+    ++this->inflight;
+  r.inflight = true;
+}
+
+void Uring::submitAfterPoll(unsigned index) {
+  Request&             r = this->requests[index];
+  struct io_uring_sqe* sqe = getSqe();
+
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = r.fd;
+  sqe->flags = IOSQE_IO_LINK;
+  sqe->poll32_events = (r.op == SEND || r.op == WRITE) ? POLLOUT : POLLIN;
+  sqe->user_data = IGNORE_TAG;
+  submit(index, 0);
+}
+
+// What the kernel refused in a way the loop can get around itself
+bool Uring::retry(unsigned index, int res) {
+  Request& r = this->requests[index];
+
+  // An O_NONBLOCK file: a worker may block on it, a pipe then needs the poll
+  if (res == -EAGAIN) {
+    r.punted = !r.punted;
+    if (r.punted)
+      submit(index, IOSQE_ASYNC);
+    else
+      submitAfterPoll(index);
+    return true;
+  }
+  if (res == -EINVAL && r.multishot) {
+    if (r.op == ACCEPT)
+      this->multishot_accept = false;
+    else
+      this->multishot_recv = false;
+    submit(index, 0);
+    return true;
+  }
+  if (r.op == WRITE && res > 0 && static_cast<size_t>(res) < r.length) {
+    r.buffer.erase(0, res);
+    r.length -= res;
+    r.done += res;
+    if (r.offset != -1)
+      r.offset += res;
+    submit(index, 0);
+    return true;
+  }
+  if (res == -ENOBUFS && r.op == RECV) {
+    ++this->inflight;
+    r.inflight = true;
+    this->starved.push_back(index);
+    return true;
+  }
+  return false;
+}
+
+void Uring::reap() {
+  __sync_synchronize();
+  unsigned head = *this->cq_head;
+  unsigned tail = *this->cq_tail;
+
+  for (; head != tail; ++head) {
+    struct io_uring_cqe*  cqe = &this->cqes[head & *this->cq_mask];
+    unsigned long long    ud = cqe->user_data;
+    int                   res = cqe->res;
+    bool                  more = cqe->flags & IORING_CQE_F_MORE;
+    const char*           data = NULL;
+
+    if (ud == IGNORE_TAG)
+      continue;
+
+    unsigned index = static_cast<unsigned>(ud);
+    Request& r = this->requests[index];
+
+    if (cqe->flags & IORING_CQE_F_BUFFER) {
+      unsigned short bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+
+      this->consumed.push_back(bid);
+      data = this->buffers + bid * BUFFER_SIZE;
+    }
+    if (!more) {
+      r.inflight = false;
+      --this->inflight;
+      // Out of buffers is as good an end as the cancel it beat
+      if (r.stopped && res == -ENOBUFS)
+        res = -ECANCELED;
+    }
+    if (r.cancelled || (!more && retry(index, res))) {
+      if (!r.inflight)
+        this->retired.push_back(index);
+      continue;
+    }
+
+    if (data == NULL && res > 0 && (r.op == READ || r.op == RECV))
+      data = r.buffer.data();
+
+    Completion c;
+    c.key = r.key;
+    c.op = r.op;
+    c.res = (r.op == WRITE && res >= 0) ? res + r.done : res;
+    c.data = data;
+    c.request = index;
+    this->completions.push_back(c);
+    if (!more)
+      this->retired.push_back(index);
+  }
+
+  __sync_synchronize();
+  *this->cq_head = head;
+  __sync_synchronize();
+}
+
+void Uring::recycle() {
+  for (size_t i = 0; i < this->retired.size(); ++i) {
+    unsigned                index = this->retired[i];
+    Request&                r = this->requests[index];
+    std::vector<unsigned>&  list = this->keys[r.key];
+
+    for (size_t j = 0; j < list.size(); ++j) {
+      if (list[j] == index) {
+        list[j] = list.back();
+        list.pop_back();
+        break;
+      }
+    }
+    std::string().swap(r.buffer);
+    this->free_requests.push_back(index);
+  }
+  this->retired.clear();
+
+  if (!this->consumed.empty()) {
+    for (size_t i = 0; i < this->consumed.size(); ++i)
+      provide(this->consumed[i]);
+    this->consumed.clear();
+    __sync_synchronize();
+    this->buf_ring[0].resv = this->buf_tail;
+  }
+
+  std::vector<unsigned> waiting;
+  waiting.swap(this->starved);
+  for (size_t i = 0; i < waiting.size(); ++i) {
+    Request& r = this->requests[waiting[i]];
+
+    --this->inflight;
+    r.inflight = false;
+    if (r.cancelled) {
+      this->retired.push_back(waiting[i]);
+      continue;
+    }
+    submit(waiting[i], 0);
+  }
+}
+
+// The tail is only published by the caller, once for a batch
+void Uring::provide(unsigned short bid) {
+  struct io_uring_buf* buf = &this->buf_ring[this->buf_tail & (BUFFERS - 1)];
+
+  buf->addr = reinterpret_cast<unsigned long long>(this->buffers + bid * BUFFER_SIZE);
+  buf->len = BUFFER_SIZE;
+  buf->bid = bid;
+  ++this->buf_tail;
+}
+
+#else
+
+Uring::Uring() { throw std::runtime_error("io_uring is Linux only"); }
+
+Uring::~Uring() {}
+
+void Uring::accept(int) {}
+
+void Uring::recv(int) {}
+
+void Uring::send(int, std::string&) {}
+
+void Uring::read(int, int, off_t, size_t) {}
+
+void Uring::write(int, int, off_t, std::string&) {}
+
+void Uring::cancel(int, int) {}
+
+void Uring::stop(int, int) {}
+
+bool Uring::isPending(int, int) const { return false; }
+
+int Uring::wait(int) { return -1; }
+
+const Uring::Completion* Uring::getCompletion(int) const { return NULL; }
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef URING_HPP
+# define URING_HPP
+
+# include <deque>
+# include <string>
+# include <vector>
+# include <sys/types.h>
+
+/*
+ * io_uring engine of a Server loop. Unlike the pollers it does the I/O:
+ * accept, recv, send, read and write are queued as SQEs and go to the
+ * kernel together with the wait, in a single io_uring_enter, and wait()
+ * hands back what they did.
+ * Accept and recv are multishot, one SQE serves a fd until it is
+ * cancelled; recv picks its memory from a ring of buffers the loop owns,
+ * so a connection closed with a recv armed never has the kernel write
+ * into freed memory. Each op reports to a key, the fd whose slot handles
+ * it, and cancel() by key drops the completions still to come. A write
+ * is reported once all of it is written.
+ * The constructor throws off Linux or when the kernel lacks an op the
+ * loop needs, the Server then runs on a poller instead. A kernel without
+ * multishot gets the single shot ops, found on their first EINVAL.
+ */
+class Uring {
+  public:
+    enum Op {
+      ACCEPT  = 1 << 0,
+      RECV    = 1 << 1,
+      SEND    = 1 << 2,
+      READ    = 1 << 3,
+      WRITE   = 1 << 4
+    };
+
+    struct Completion {
+      int                           key;
+      Op                            op;
+      // Bytes moved or the accepted fd, -errno on failure
+      int                           res;
+      // What RECV and READ brought in, valid until the next wait()
+      const char*                   data;
+      unsigned                      request;
+    };
+
+    Uring();
+    ~Uring();
+
+    // Both armed until cancelled
+    void                            accept(int fd);
+    void                            recv(int fd);
+    // Takes the content of data, which is left empty
+    void                            send(int fd, std::string& data);
+    // offset -1 reads and writes at the file position
+    void                            read(int key, int fd, off_t offset, size_t length);
+    void                            write(int key, int fd, off_t offset, std::string& data);
+
+    // The ops of key in ops, their completions are not reported anymore
+    void                            cancel(int key, int ops);
+    // The ops of key in ops end, what they did until then is still
+    // reported and the last completion of each is -ECANCELED
+    void                            stop(int key, int ops);
+    bool                            isPending(int key, int ops) const;
+
+    // Returns the number of completions, -1 on error
+    int                             wait(int timeout_ms);
+    // NULL once the op was cancelled by an earlier completion's handler
+    const Completion*               getCompletion(int i) const;
+
+  private:
+    static const unsigned           ENTRIES;
+    // Provided to multishot recv, a power of two
+    static const unsigned           BUFFERS;
+    static const size_t             BUFFER_SIZE;
+    static const unsigned long long IGNORE_TAG;
+
+    struct Request {
+      int                           key;
+      int                           fd;
+      Op                            op;
+      off_t                         offset;
+      size_t                        length;
+      // Written by the earlier SQEs of a short write
+      size_t                        done;
+      // Read into or written from, the kernel holds it until the last CQE
+      std::string                   buffer;
+      bool                          inflight;
+      // Pending until its last completion went to a handler, which a
+      // completion of the same wait() may not have yet
+      mutable bool                  reported;
+      bool                          cancelled;
+      bool                          stopped;
+      bool                          multishot;
+      // Sent once to io-wq after an EAGAIN, behind a poll after the next
+      bool                          punted;
+
+      Request();
+    };
+
+    int                             ring_fd;
+
+    void*                           sq_ring;
+    size_t                          sq_ring_size;
+    void*                           cq_ring;
+    size_t                          cq_ring_size;
+    struct io_uring_sqe*            sqes;
+    size_t                          sqes_size;
+
+    unsigned*                       sq_head;
+    unsigned*                       sq_tail;
+    unsigned*                       sq_mask;
+    unsigned*                       sq_array;
+    unsigned                        sq_entries;
+    unsigned                        sq_local_tail;
+
+    unsigned*                       cq_head;
+    unsigned*                       cq_tail;
+    unsigned*                       cq_mask;
+    struct io_uring_cqe*            cqes;
+
+    // Provided buffers, NULL without kernel support
+    struct io_uring_buf*            buf_ring;
+    char*                           buffers;
+    unsigned short                  buf_tail;
+    bool                            multishot_accept;
+    bool                            multishot_recv;
+
+    // Never moves, the kernel keeps pointers into the buffers
+    std::deque<Request>             requests;
+    std::vector<unsigned>           free_requests;
+    // key, its requests
+    std::vector<std::vector<unsigned> > keys;
+    unsigned                        inflight;
+
+    // Released at the start of the next wait(), the handlers still read them
+    std::vector<unsigned>           retired;
+    std::vector<unsigned short>     consumed;
+    // Recv ended by ENOBUFS, armed again once buffers are back
+    std::vector<unsigned>           starved;
+    std::vector<Completion>         completions;
+
+    void                            setup();
+    void                            probe();
+    void                            setupBuffers();
+    void                            release();
+    void                            drain();
+    int                             enter(unsigned min_complete, int timeout_ms);
+    struct io_uring_sqe*            getSqe();
+
+    unsigned                        allocate(int key, int fd, Op op);
+    void                            submit(unsigned index, unsigned flags);
+    void                            submitAfterPoll(unsigned index);
+    bool                            retry(unsigned index, int res);
+    void                            reap();
+    void                            recycle();
+    void                            provide(unsigned short bid);
+
+    Uring(const Uring& obj);
+    Uring&                          operator=(const Uring& obj);
+};
+
+#endif